@@ -5,20 +5,34 @@
 #include <memory>
 #include <iostream>
 #include <cassert>
+#include <cstring>
 #include <string>
 #include <set>
 #include <sstream>
 #include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include "DerivativeCompiler.h"
 #include "DFAutomaton.h"
 #include "NFAutomaton.h"
 #include "ENFAutomaton.h"
 #include "ArraySlice.h"
+#include "BatchMatcher.h"
+#include "DFAImage.h"
+#include "GlushkovMatcher.h"
 #include "TransitionTable.h"
 #include "AutomatonParser.h"
+#include "AutomatonReader.h"
+#include "AutomatonWriter.h"
 #include "HashExtensions.h"
 #include "LambdaFunction.h"
+#include "LazyDFA.h"
 #include "AutomatonDotPrinter.h"
 #include "RegexParser.h"
+#include "RegexSet.h"
+#include "Searcher.h"
+#include "StreamMatcher.h"
+#include "SubsetTable.h"
 
 #include "DFAtoRE.h"
 
@@ -48,33 +62,141 @@ State NameSets(LinearSet<State> vals)
 	return result.str();
 }
 
-State NameRegexState(std::shared_ptr<RegexState> State, std::unordered_map<std::shared_ptr<RegexState>, int>& Named)
+std::vector<State> NameSubsets(const Automata::SubsetTable& Subsets, const std::vector<State>& States)
 {
-	auto iter = Named.find(State);
-	if (Named.end() == iter) // Key not in dict
+	std::vector<State> results;
+	results.reserve(Subsets.getCount());
+	for (uint32_t id = 0; id < Subsets.getCount(); id++)
 	{
-		Named[State] = Named.size();
+		std::set<State> states;
+		auto items = Subsets.GetItems(id);
+		for (uint32_t i = 0; i < Subsets.GetSize(id); i++)
+		{
+			states.insert(States[items[i]]);
+		}
+		std::ostringstream result;
+		result << "{";
+		bool first = true;
+		for (auto& item : states)
+		{
+			if (!first)
+			{
+				result << ",";
+			}
+			first = false;
+			result << item;
+		}
+		result << "}";
+		results.push_back(result.str());
 	}
+	return results;
+}
+
+State NameState(uint32_t Id)
+{
 	std::ostringstream ss;
-	ss << Named[State];
+	ss << Id;
 	return ss.str();
 }
 
-int main(int argc, const char* argv[])
+// Checks if the given arguments ask for compact output, which names
+// states q0, q1, ... instead of after the states they were built from.
+bool IsCompact(int argc, const char* argv[])
+{
+	return argc > 4 && std::string(argv[4]) == "--compact";
+}
+
+// Checks if the given arguments vouch for the compiled image that
+// accepts matches in place, so that its transition table need not be
+// checked.
+bool IsTrusted(int argc, const char* argv[])
+{
+	return argc > 4 && std::string(argv[4]) == "--trusted";
+}
+
+// Writes the given DFA with compact state names to the output file
+// in argv[3]. If a side file is given after the --compact flag, the
+// states that every DFA state was built from are written to it.
+void WriteCompact(const Automata::CompiledDFA<Symbol>& Dfa, const Automata::SubsetTable& Subsets, const std::vector<State>& States, int argc, const char* argv[])
+{
+	std::ofstream output(argv[3], std::ios::binary);
+	Automata::AutomatonWriter writer(output);
+	writer.Write(Dfa);
+	if (argc > 5)
+	{
+		std::ofstream subsetOutput(argv[5], std::ios::binary);
+		Automata::AutomatonWriter subsetWriter(subsetOutput);
+		subsetWriter.WriteSubsets(Dfa, Subsets, States);
+	}
+}
+
+// Checks if the given file contains a regex, based on its extension.
+bool IsRegexPath(const std::string& Path)
+{
+	return Path.size() >= 3 && Path.compare(Path.size() - 3, 3, ".re") == 0;
+}
+
+// Parses the regex in the given regex file. The line break that ends
+// the file is not part of the regex.
+std::shared_ptr<IRegex> ReadRegex(std::istream& Input)
+{
+	std::string pattern((std::istreambuf_iterator<char>(Input)), std::istreambuf_iterator<char>());
+	while (!pattern.empty() && (pattern.back() == '\n' || pattern.back() == '\r'))
+	{
+		pattern.pop_back();
+	}
+	std::istringstream patternInput(pattern);
+	RegexParser regexParser(patternInput);
+	return regexParser.ParseRegex();
+}
+
+// Compiles the pattern in the given file, which is a regex if the
+// file's extension is .re, a compiled image if it starts with an
+// image's magic bytes, and an automaton otherwise.
+Automata::CompiledDFA<Symbol> ReadPattern(const std::string& Path, std::istream& Input)
+{
+	if (Automata::DFAImage::IsImage(Path))
+	{
+		return Automata::DFAImage(Path).ToCompiledDFA();
+	}
+	else if (IsRegexPath(Path))
+	{
+		auto regex = ReadRegex(Input);
+		Automata::DerivativeCompiler compiler;
+		return compiler.Compile(regex.get());
+	}
+
+	Automata::AutomatonReader reader(Path);
+	return reader.ToCompiledDFA();
+}
+
+// Runs the command that the given arguments describe. Malformed input
+// files are reported by throwing an exception.
+int RunCommand(int argc, const char* argv[])
 {
 	if (argc < 2)
 	{
 		std::cout << "No arguments have been specified. Give me something to do:" << std::endl;
-		std::cout << " * ssc <input file>.nfa <output file>.dfa (NFA->DFA conversion)" << std::endl;
-		std::cout << " * mssc <input file>.enfa <output file>.dfa (e-NFA->DFA conversion)" << std::endl;
-		std::cout << " * accepts <input file> <string> (test a string)" << std::endl;
+		std::cout << " * ssc <input file>.nfa <output file>.dfa [--compact [<subsets file>]] (NFA->DFA conversion)" << std::endl;
+		std::cout << " * mssc <input file>.enfa <output file>.dfa [--compact [<subsets file>]] (e-NFA->DFA conversion)" << std::endl;
+		std::cout << " * accepts <regex or automaton file> <string> [--trusted] (test a string)" << std::endl;
+		std::cout << "   --trusted matches a compiled image without checking its transition table first" << std::endl;
+		std::cout << " * batch <regex or automaton file> [<strings file>] (test every line of a file, or of stdin)" << std::endl;
+		std::cout << " * compile <regex or automaton file> <output file> (write a minimal DFA as a binary image)" << std::endl;
 		std::cout << " * dot <input file>.dfa <target file>.dot (gets a dot language representation)" << std::endl;
+		std::cout << " * enfa2nfa <input file>.enfa <output file>.nfa (e-NFA->NFA conversion)" << std::endl;
 		std::cout << " * re2enfa <input file>.re <target file>.enfa (regex->e-NFA conversion)" << std::endl;
+		std::cout << " * re2nfa <input file>.re <target file>.nfa (regex->NFA position automaton)" << std::endl;
+		std::cout << " * re2dfa <input file>.re <target file>.dfa (regex->DFA conversion by derivatives)" << std::endl;
 		std::cout << " * dfa2re <input file>.dfa <target file>.re (DFA->regex conversion)" << std::endl;
 		std::cout << " * nfa2re <input file>.nfa <target file>.re (NFA->regex conversion)" << std::endl;
 		std::cout << " * partition <input file>.dfa (show sets of equivalent states)" << std::endl;
-		std::cout << " * optimize <input file>.dfa <output file>.dfa (DFA optimization)" << std::endl;
+		std::cout << " * optimize <input file>.dfa <output file>.dfa [--compact [<subsets file>]] (DFA optimization)" << std::endl;
+		std::cout << "   --compact names states q0, q1, ... and lists the states they were built from in the subsets file" << std::endl;
 		std::cout << " * equivalent <input file A>.dfa <input file B>.dfa (DFA equivalence)" << std::endl;
+		std::cout << " * search <regex or automaton file> <text file> (find all matches on every line)" << std::endl;
+		std::cout << " * stream <regex or automaton file> <input file> [<chunk size>] (test a whole file, one chunk at a time)" << std::endl;
+		std::cout << " * matchset <pattern list file> <string> (test a string against many patterns at once)" << std::endl;
 		return 0;
 	}
 
@@ -111,35 +233,59 @@ int main(int argc, const char* argv[])
 	}
 	else if (std::string(argv[1]) == "ssc")
 	{
-		auto nfa = parser.ReadNFAutomaton(input);
+		std::vector<State> states;
+		auto nfa = parser.ReadNFAutomaton(input).Compile(parser.Symbols, states);
 		input.close();
-		auto dfa = nfa.ToDFAutomaton();
+		Automata::SubsetTable subsets;
+		auto dfa = nfa.Determinize(subsets, 0);
 
-		auto setRenamer = Automata::LambdaFunction<LinearSet<State>, State>(NameSets);
-		IdFunction<Symbol> charRenamer;
+		if (IsCompact(argc, argv))
+		{
+			WriteCompact(dfa, subsets, states, argc, argv);
+		}
+		else
+		{
+			auto renamedDfa = dfa.ToDFAutomaton(NameSubsets(subsets, states));
 
-		auto renamedDfa = dfa.Rename(&setRenamer, &charRenamer);
+			std::ofstream output(argv[3]);
 
-		std::ofstream output(argv[3]);
+			parser.Write(renamedDfa, output);
 
-		parser.Write(renamedDfa, output);
-
-		output.close();
+			output.close();
+		}
 	}
 	else if (std::string(argv[1]) == "mssc")
 	{
-		auto enfa = parser.ReadENFAutomaton(input);
+		std::vector<State> states;
+		auto enfa = parser.ReadENFAutomaton(input).Compile(parser.Symbols, states);
 		input.close();
-		auto dfa = enfa.ToDFAutomaton();
+		Automata::SubsetTable subsets;
+		auto dfa = enfa.Determinize(subsets, 0);
 
-		auto setRenamer = Automata::LambdaFunction<LinearSet<State>, State>(NameSets);
-		IdFunction<Symbol> charRenamer;
+		if (IsCompact(argc, argv))
+		{
+			WriteCompact(dfa, subsets, states, argc, argv);
+		}
+		else
+		{
+			auto renamedDfa = dfa.ToDFAutomaton(NameSubsets(subsets, states));
 
-		auto renamedDfa = dfa.Rename(&setRenamer, &charRenamer);
+			std::ofstream output(argv[3]);
+
+			parser.Write(renamedDfa, output);
+
+			output.close();
+		}
+	}
+	else if (std::string(argv[1]) == "enfa2nfa")
+	{
+		auto enfa = parser.ReadENFAutomaton(input);
+		input.close();
+		auto nfa = enfa.RemoveEpsilons();
 
 		std::ofstream output(argv[3]);
 
-		parser.Write(renamedDfa, output);
+		parser.Write(nfa, output);
 
 		output.close();
 	}
@@ -152,8 +298,7 @@ int main(int argc, const char* argv[])
 
 		auto enfa = regex->ToENFAutomaton();
 
-		std::unordered_map<std::shared_ptr<RegexState>, int> names;
-		auto setRenamer = Automata::LambdaFunction<std::shared_ptr<RegexState>, State>([&](std::shared_ptr<RegexState> state) { return NameRegexState(state, names); });
+		auto setRenamer = Automata::LambdaFunction<uint32_t, State>(NameState);
 		IdFunction<Symbol> charRenamer;
 
 		auto renamedEnfa = enfa.Rename<State, Symbol>(&setRenamer, &charRenamer);
@@ -164,6 +309,46 @@ int main(int argc, const char* argv[])
 
 		output.close();
 	}
+	else if (std::string(argv[1]) == "re2nfa")
+	{
+		auto regex = ReadRegex(input);
+		input.close();
+
+		auto nfa = regex->ToNFAutomaton();
+
+		auto setRenamer = Automata::LambdaFunction<uint32_t, State>(NameState);
+		IdFunction<Symbol> charRenamer;
+
+		auto renamedNfa = nfa.Rename<State, Symbol>(&setRenamer, &charRenamer);
+
+		std::ofstream output(argv[3]);
+
+		parser.Write(renamedNfa, output);
+
+		output.close();
+	}
+	else if (std::string(argv[1]) == "re2dfa")
+	{
+		auto regex = ReadRegex(input);
+		input.close();
+
+		Automata::DerivativeCompiler compiler;
+		auto dfa = compiler.Compile(regex.get());
+
+		std::vector<State> names;
+		for (uint32_t i = 0; i < dfa.getStateCount(); i++)
+		{
+			names.push_back(NameState(i));
+		}
+
+		auto renamedDfa = dfa.ToDFAutomaton(names);
+
+		std::ofstream output(argv[3]);
+
+		parser.Write(renamedDfa, output);
+
+		output.close();
+	}
 	else if (std::string(argv[1]) == "dfa2re")
 	{
 		auto dfa = parser.ReadDFAutomaton(input);
@@ -183,26 +368,57 @@ int main(int argc, const char* argv[])
 		auto dfa = parser.ReadDFAutomaton(input);
 		std::cout << "The following sets of states are equivalent:" << std::endl;
 		std::set<State> uniqueEntries;
-		for (auto &item : dfa.TFAPartition())
-			uniqueEntries.insert(NameSets(item.second));
+		for (auto &item : dfa.HopcroftPartition())
+			uniqueEntries.insert(NameSets(item));
 		for (auto s : uniqueEntries)
 			std::cout << "- " << s << std::endl;
 	}
 	else if (std::string(argv[1]) == "optimize")
 	{
-		auto dfa = parser.ReadDFAutomaton(input);
-		auto newDfa = dfa.Optimize();
+		if (IsCompact(argc, argv))
+		{
+			// Every state of the minimal DFA is a block of equivalent
+			// input states. The blocks are disjoint, so adding them in
+			// order gives every block the id of its state.
+			std::vector<State> states;
+			auto dfa = parser.ReadDFAutomaton(input).Compile(parser.Symbols, states);
+			input.close();
+			std::vector<uint32_t> stateMap;
+			auto minimalDfa = dfa.Minimize(stateMap);
+			std::vector<std::vector<uint32_t>> blocks(minimalDfa.getStateCount());
+			// State zero is the dead state that Compile adds, which is
+			// not one of the input's states.
+			for (uint32_t q = 1; q < dfa.getStateCount(); q++)
+			{
+				if (stateMap[q] != Automata::CompiledDFA<Symbol>::NoState)
+				{
+					blocks[stateMap[q]].push_back(q);
+				}
+			}
+			Automata::SubsetTable subsets;
+			bool added;
+			for (auto& block : blocks)
+			{
+				subsets.Add(block.data(), block.size(), added);
+			}
+			WriteCompact(minimalDfa, subsets, states, argc, argv);
+		}
+		else
+		{
+			auto dfa = parser.ReadDFAutomaton(input);
+			auto newDfa = dfa.Optimize();
 
-		auto setRenamer = Automata::LambdaFunction<LinearSet<State>, State>(NameSets);
-		IdFunction<Symbol> charRenamer;
+			auto setRenamer = Automata::LambdaFunction<LinearSet<State>, State>(NameSets);
+			IdFunction<Symbol> charRenamer;
 
-		auto renamedDfa = newDfa.Rename(&setRenamer, &charRenamer);
+			auto renamedDfa = newDfa.Rename(&setRenamer, &charRenamer);
 
-		std::ofstream output(argv[3]);
+			std::ofstream output(argv[3]);
 
-		parser.Write(renamedDfa, output);
+			parser.Write(renamedDfa, output);
 
-		output.close();
+			output.close();
+		}
 	}
 	else if (std::string(argv[1]) == "equivalent")
 	{
@@ -232,17 +448,237 @@ int main(int argc, const char* argv[])
 
 		output.close();
 	}
-	else
+	else if (std::string(argv[1]) == "search")
 	{
-		auto automaton = parser.ReadAutomaton(input);
+		std::ifstream text(argv[3], std::ios::binary);
+		if (!text)
+		{
+			std::cout << "Input file '" << argv[3] << "' could not be opened." << std::endl;
+			return 0;
+		}
 
-		std::vector<std::string> parsedString;
-		for (char item : std::string(argv[3]))
+		Automata::Searcher<Symbol> searcher(ReadPattern(argv[2], input));
+		input.close();
+
+		// The text is streamed one line at a time, so only the current
+		// line is ever held in memory. Matches are printed as their line
+		// number, followed by their byte offsets in the whole file.
+		std::string line;
+		std::size_t lineNumber = 0;
+		std::size_t offset = 0;
+		while (std::getline(text, line))
 		{
-			parsedString.push_back(std::string(1, item));
+			lineNumber++;
+			for (auto& match : searcher.FindAll(line.data(), line.size()))
+			{
+				std::cout << lineNumber << ":" << offset + match.Start << "-" << offset + match.End << ":"
+					<< line.substr(match.Start, match.End - match.Start) << "\n";
+			}
+			offset += line.size() + 1;
 		}
+	}
+	else if (std::string(argv[1]) == "stream")
+	{
+		std::ifstream data(argv[3], std::ios::binary);
+		if (!data)
+		{
+			std::cout << "Input file '" << argv[3] << "' could not be opened." << std::endl;
+			return 0;
+		}
+		std::size_t chunkSize = argc > 4 ? std::stoul(argv[4]) : 1 << 16;
+		if (chunkSize == 0)
+		{
+			std::cout << "The chunk size must be positive." << std::endl;
+			return 0;
+		}
+
+		Automata::StreamMatcher<Symbol> matcher(ReadPattern(argv[2], input));
+		input.close();
+
+		// Only one chunk of the file is ever held in memory, and reading
+		// stops as soon as no continuation of the input can be accepted.
+		std::vector<char> buffer(chunkSize);
+		while (!matcher.getIsDead() && data.read(buffer.data(), chunkSize).gcount() > 0)
+		{
+			matcher.Feed(buffer.data(), (std::size_t)data.gcount());
+		}
+
+		if (matcher.getIsAccepting())
+		{
+			std::cout << "The automaton accepts the given file." << std::endl;
+		}
+		else
+		{
+			std::cout << "The automaton did not accept the given file." << std::endl;
+		}
+	}
+	else if (std::string(argv[1]) == "matchset")
+	{
+		// Every line of the list file names a regex or automaton file.
+		Automata::RegexSet<Symbol> patterns;
+		std::vector<std::string> paths;
+		std::string path;
+		while (std::getline(input, path))
+		{
+			if (path.empty())
+			{
+				continue;
+			}
+			std::ifstream patternInput(path);
+			if (!patternInput)
+			{
+				std::cout << "Input file '" << path << "' could not be opened." << std::endl;
+				return 0;
+			}
+			patterns.Add(ReadPattern(path, patternInput));
+			paths.push_back(path);
+		}
+		input.close();
 
-		if (automaton->Accepts(parsedString))
+		std::string inputString(argv[3]);
+		std::vector<uint32_t> matches;
+		patterns.Match(inputString.data(), inputString.size(), matches);
+		std::cout << "The following patterns accept the given string:" << std::endl;
+		for (auto pattern : matches)
+		{
+			std::cout << "- " << paths[pattern] << std::endl;
+		}
+	}
+	else if (std::string(argv[1]) == "compile")
+	{
+		auto dfa = ReadPattern(argv[2], input).Minimize();
+		input.close();
+
+		std::ofstream output(argv[3], std::ios::binary);
+		Automata::DFAImage::Write(dfa, output);
+		if (!output)
+		{
+			std::cout << "Output file '" << argv[3] << "' could not be written." << std::endl;
+			return 0;
+		}
+	}
+	else if (std::string(argv[1]) == "batch")
+	{
+		std::unique_ptr<Automata::BatchMatcher<Symbol>> matcher;
+		std::string patternPath(argv[2]);
+		if (IsRegexPath(patternPath) || Automata::DFAImage::IsImage(patternPath))
+		{
+			matcher.reset(new Automata::BatchMatcher<Symbol>(
+				std::make_shared<Automata::CompiledDFA<Symbol>>(ReadPattern(patternPath, input)), 0));
+		}
+		else
+		{
+			Automata::AutomatonReader reader(patternPath);
+			if (reader.getType() == parser.Deterministic)
+			{
+				matcher.reset(new Automata::BatchMatcher<Symbol>(
+					std::make_shared<Automata::CompiledDFA<Symbol>>(reader.ToCompiledDFA()), 0));
+			}
+			else
+			{
+				matcher.reset(new Automata::BatchMatcher<Symbol>(
+					std::make_shared<Automata::CompiledNFA<Symbol>>(reader.ToCompiledNFA()), 0));
+			}
+		}
+		input.close();
+
+		std::ifstream stringsFile;
+		if (argc > 3)
+		{
+			stringsFile.open(argv[3], std::ios::binary);
+			if (!stringsFile)
+			{
+				std::cout << "Input file '" << argv[3] << "' could not be opened." << std::endl;
+				return 0;
+			}
+		}
+		std::istream& strings = argc > 3 ? stringsFile : std::cin;
+
+		// The strings are read in large chunks, and every chunk's
+		// complete lines are tested as one batch. A line that straddles
+		// two chunks is carried over to the next chunk.
+		const std::size_t chunkSize = 1 << 24;
+		std::vector<char> buffer;
+		std::size_t pending = 0;
+		std::vector<std::size_t> starts;
+		std::vector<std::size_t> ends;
+		std::vector<uint8_t> results;
+		std::string output;
+		bool atEnd = false;
+		while (!atEnd)
+		{
+			buffer.resize(pending + chunkSize);
+			strings.read(buffer.data() + pending, chunkSize);
+			auto size = pending + (std::size_t)strings.gcount();
+			atEnd = !strings;
+
+			starts.clear();
+			ends.clear();
+			std::size_t lineStart = 0;
+			while (lineStart < size)
+			{
+				auto lineBreak = (const char*)std::memchr(buffer.data() + lineStart, '\n', size - lineStart);
+				if (lineBreak == nullptr && !atEnd)
+				{
+					break;
+				}
+				auto lineEnd = lineBreak == nullptr ? size : (std::size_t)(lineBreak - buffer.data());
+				starts.push_back(lineStart);
+				ends.push_back(lineEnd > lineStart && buffer[lineEnd - 1] == '\r' ? lineEnd - 1 : lineEnd);
+				lineStart = lineEnd + 1;
+			}
+
+			matcher->Accepts(buffer.data(), starts, ends, results);
+			output.clear();
+			for (auto result : results)
+			{
+				output += result ? "accepted\n" : "rejected\n";
+			}
+			std::cout.write(output.data(), output.size());
+
+			pending = lineStart < size ? size - lineStart : 0;
+			std::memmove(buffer.data(), buffer.data() + size - pending, pending);
+		}
+	}
+	else
+	{
+		// The input string is matched byte by byte against the compiled
+		// automaton, so no symbol strings are created or hashed.
+		// Compiled images are matched straight from the mapped file, after
+		// one pass that checks their transitions unless they are trusted, and
+		// regexes are matched by simulating their position automaton,
+		// without determinizing them first.
+		std::string inputString(argv[3]);
+		bool accepted;
+		if (Automata::DFAImage::IsImage(argv[2]))
+		{
+			Automata::DFAImage image(argv[2]);
+			if (!IsTrusted(argc, argv))
+			{
+				image.Validate();
+			}
+			accepted = image.Accepts(inputString.data(), inputString.size());
+		}
+		else if (IsRegexPath(argv[2]))
+		{
+			Automata::GlushkovMatcher matcher(ReadRegex(input));
+			accepted = matcher.Accepts(inputString.data(), inputString.size());
+		}
+		else
+		{
+			Automata::AutomatonReader reader(argv[2]);
+			if (reader.getType() == parser.Deterministic)
+			{
+				accepted = reader.ToCompiledDFA().Accepts(inputString.data(), inputString.size());
+			}
+			else
+			{
+				Automata::LazyDFA<Symbol> dfa(std::make_shared<Automata::CompiledNFA<Symbol>>(reader.ToCompiledNFA()));
+				accepted = dfa.Accepts(inputString.data(), inputString.size());
+			}
+		}
+
+		if (accepted)
 		{
 			std::cout << "The automaton accepts the given string." << std::endl;
 		}
@@ -254,3 +690,18 @@ int main(int argc, const char* argv[])
 
 	return 0;
 }
+
+int main(int argc, const char* argv[])
+{
+	// Readers report malformed automaton files and images, with the
+	// offending line where there is one, by throwing.
+	try
+	{
+		return RunCommand(argc, argv);
+	}
+	catch (const std::exception& e)
+	{
+		std::cout << e.what() << std::endl;
+		return 0;
+	}
+}
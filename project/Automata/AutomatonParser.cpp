@@ -87,6 +87,7 @@ AutomatonParser::DFA AutomatonParser::ReadDFAutomaton(std::istream& Input)
 				State b;
 				Symbol c;
 				Input >> c >> b;
+				Symbols.Intern(c);
 				trans[std::pair<State, Symbol>(a, c)] = b;
 				Input >> a;
 			}
@@ -128,6 +129,7 @@ AutomatonParser::NFA AutomatonParser::ReadNFAutomaton(std::istream& Input)
 				State b;
 				Symbol c;
 				Input >> c >> b;
+				Symbols.Intern(c);
 				trans[std::pair<State, Symbol>(a, c)].Add(b);
 				Input >> a;
 			}
@@ -175,6 +177,7 @@ AutomatonParser::ENFA AutomatonParser::ReadENFAutomaton(std::istream& Input)
 				}
 				else
 				{
+					Symbols.Intern(c);
 					trans[std::pair<State, Optional<Symbol>>(a, Optional<Symbol>(c))].Add(b);
 				}
 				Input >> a;
@@ -192,47 +195,47 @@ AutomatonParser::ENFA AutomatonParser::ReadENFAutomaton(std::istream& Input)
 
 void AutomatonParser::Write(AutomatonParser::ENFA Value, std::ostream& Output)
 {
-	Output << "enfa" << std::endl;
-	Output << "start " << Value.getStartState() << std::endl;
-	Output << "accepts" << Value.getAcceptingStates() << std::endl;
-	Output << "transitions" << std::endl;
+	Output << "enfa\n";
+	Output << "start " << Value.getStartState() << "\n";
+	Output << "accepts" << Value.getAcceptingStates() << "\n";
+	Output << "transitions\n";
 	for (auto& item : Value.getTransitionFunction().getMap())
 	{
 		for (auto& targetState : item.second.getItems())
 		{
 			if (item.first.second.HasValue)
 			{
-				Output << item.first.first << " " << item.first.second.Value << " " << targetState << std::endl;
+				Output << item.first.first << " " << item.first.second.Value << " " << targetState << "\n";
 			}
 			else
 			{
-				Output << item.first.first << " -> " << targetState << std::endl;
+				Output << item.first.first << " -> " << targetState << "\n";
 			}
 		}
 	}
 }
 void AutomatonParser::Write(AutomatonParser::NFA Value, std::ostream& Output)
 {
-	Output << "nfa" << std::endl;
-	Output << "start " << Value.getStartState() << std::endl;
-	Output << "accepts" << Value.getAcceptingStates() << std::endl;
-	Output << "transitions" << std::endl;
+	Output << "nfa\n";
+	Output << "start " << Value.getStartState() << "\n";
+	Output << "accepts" << Value.getAcceptingStates() << "\n";
+	Output << "transitions\n";
 	for (auto& item : Value.getTransitionFunction().getMap())
 	{
 		for (auto& targetState : item.second.getItems())
 		{
-			Output << item.first.first << " " << item.first.second << " " << targetState << std::endl;
+			Output << item.first.first << " " << item.first.second << " " << targetState << "\n";
 		}
 	}
 }
 void AutomatonParser::Write(AutomatonParser::DFA Value, std::ostream& Output)
 {
-	Output << "dfa" << std::endl;
-	Output << "start " << Value.getStartState() << std::endl;
-	Output << "accepts" << Value.getAcceptingStates() << std::endl;
-	Output << "transitions" << std::endl;
+	Output << "dfa\n";
+	Output << "start " << Value.getStartState() << "\n";
+	Output << "accepts" << Value.getAcceptingStates() << "\n";
+	Output << "transitions\n";
 	for (auto& item : Value.getTransitionFunction().getMap())
 	{
-		Output << item.first.first << " " << item.first.second << " " << item.second << std::endl;
+		Output << item.first.first << " " << item.first.second << " " << item.second << "\n";
 	}
 }
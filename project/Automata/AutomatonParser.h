@@ -4,6 +4,7 @@
 #include "NFAutomaton.h"
 #include "DFAutomaton.h"
 #include "ENFAutomaton.h"
+#include "SymbolTable.h"
 
 namespace Automata
 {
@@ -32,5 +33,10 @@ namespace Automata
 		void Write(NFA Value, std::ostream& Output);
 		void Write(DFA Value, std::ostream& Output);
 		void Write(ENFA Value, std::ostream& Output);
+
+		/// \brief Every symbol that has been read by this parser, numbered
+		/// in order of first appearance. Compiling automata against this
+		/// table gives them consistent symbol ids.
+		SymbolTable<Symbol> Symbols;
 	};
 }
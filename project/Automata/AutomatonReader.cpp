@@ -0,0 +1,366 @@
+#include "AutomatonReader.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "AutomatonParser.h"
+#include "CompiledDFA.h"
+#include "CompiledNFA.h"
+#include "MappedFile.h"
+#include "SymbolTable.h"
+
+using namespace Automata;
+
+namespace
+{
+    /// \brief Splits a buffer into whitespace-separated tokens, and keeps
+    /// track of the line that the most recent token is on.
+    class Scanner
+    {
+    public:
+        Scanner(const char* Data, std::size_t Size)
+            : position(Data), end(Data + Size), line(1)
+        { }
+
+        /// \brief Reads the next token, on any line. Returns false if
+        /// there are no tokens left.
+        bool Next(const char*& Token, std::size_t& Length)
+        {
+            while (this->position != this->end && IsSpace(*this->position))
+            {
+                if (*this->position == '\n')
+                    this->line++;
+                this->position++;
+            }
+            return this->ReadToken(Token, Length);
+        }
+
+        /// \brief Reads the next token on the current line. Returns false,
+        /// and moves on to the next line, if the current line has no
+        /// tokens left.
+        bool NextOnLine(const char*& Token, std::size_t& Length)
+        {
+            while (this->position != this->end && IsSpace(*this->position))
+            {
+                if (*this->position == '\n')
+                {
+                    this->line++;
+                    this->position++;
+                    return false;
+                }
+                this->position++;
+            }
+            return this->ReadToken(Token, Length);
+        }
+
+        /// \brief Gets the number of the line that the scanner is on.
+        std::size_t getLine() const
+        {
+            return this->line;
+        }
+    private:
+        static bool IsSpace(char Value)
+        {
+            return Value == ' ' || (Value >= '\t' && Value <= '\r');
+        }
+
+        bool ReadToken(const char*& Token, std::size_t& Length)
+        {
+            if (this->position == this->end)
+                return false;
+
+            Token = this->position;
+            while (this->position != this->end && !IsSpace(*this->position))
+                this->position++;
+            Length = (std::size_t)(this->position - Token);
+            return true;
+        }
+
+        const char* position;
+        const char* end;
+        std::size_t line;
+    };
+
+    /// \brief Assigns dense ids to names, in order of first appearance.
+    /// Names are copied into a single contiguous buffer, so looking up
+    /// a name never touches the (much larger) buffer that it was
+    /// scanned from. Every slot also holds the first bytes of its name,
+    /// so short names are compared without leaving the slot.
+    class NameTable
+    {
+    public:
+        NameTable()
+            : slots(1024), offsets(1, 0)
+        { }
+
+        /// \brief Gets the id of the given name, and assigns it the next
+        /// id if it does not have one yet.
+        uint32_t Intern(const char* Name, std::size_t Length)
+        {
+            auto prefix = GetPrefix(Name, Length);
+            auto mask = this->slots.size() - 1;
+            auto index = Hash(Name, Length) & mask;
+            while (this->slots[index].Id != NoName)
+            {
+                auto& slot = this->slots[index];
+                if (slot.Prefix == prefix && slot.Length == Length
+                    && (Length <= sizeof(uint64_t)
+                        || std::memcmp(this->names.data() + this->offsets[slot.Id], Name, Length) == 0))
+                    return slot.Id;
+                index = (index + 1) & mask;
+            }
+
+            auto id = this->getCount();
+            this->names.insert(this->names.end(), Name, Name + Length);
+            this->offsets.push_back(this->names.size());
+            this->slots[index].Prefix = prefix;
+            this->slots[index].Length = (uint32_t)Length;
+            this->slots[index].Id = id;
+            if ((std::size_t)id * 2 > this->slots.size())
+                this->Grow();
+            return id;
+        }
+
+        /// \brief Gets the name with the given id.
+        std::string GetName(uint32_t Id) const
+        {
+            return std::string(this->names.data() + this->offsets[Id],
+                               this->names.data() + this->offsets[Id + 1]);
+        }
+
+        /// \brief Gets the number of names in this table.
+        uint32_t getCount() const
+        {
+            return (uint32_t)(this->offsets.size() - 1);
+        }
+    private:
+        static const uint32_t NoName = 0xFFFFFFFF;
+
+        /// \brief A slot of the hash table, which is empty if its id is
+        /// NoName.
+        struct Slot
+        {
+            Slot()
+                : Prefix(0), Length(0), Id(NoName)
+            { }
+
+            uint64_t Prefix;
+            uint32_t Length;
+            uint32_t Id;
+        };
+
+        static std::size_t Hash(const char* Name, std::size_t Length)
+        {
+            uint64_t hash = 14695981039346656037ULL;
+            for (std::size_t i = 0; i < Length; i++)
+                hash = (hash ^ (unsigned char)Name[i]) * 1099511628211ULL;
+            return (std::size_t)(hash ^ (hash >> 32));
+        }
+
+        /// \brief Gets the first eight bytes of the given name, padded
+        /// with zeros.
+        static uint64_t GetPrefix(const char* Name, std::size_t Length)
+        {
+            uint64_t prefix = 0;
+            std::memcpy(&prefix, Name, Length < sizeof(prefix) ? Length : sizeof(prefix));
+            return prefix;
+        }
+
+        /// \brief Doubles the number of slots, and reinserts every name.
+        void Grow()
+        {
+            std::vector<Slot> grown(this->slots.size() * 2);
+            auto mask = grown.size() - 1;
+            for (auto& slot : this->slots)
+            {
+                if (slot.Id == NoName)
+                    continue;
+                auto index = Hash(this->names.data() + this->offsets[slot.Id], slot.Length) & mask;
+                while (grown[index].Id != NoName)
+                    index = (index + 1) & mask;
+                grown[index] = slot;
+            }
+            this->slots.swap(grown);
+        }
+
+        std::vector<Slot> slots;
+        std::vector<char> names;
+        std::vector<std::size_t> offsets;
+    };
+
+    const uint32_t NameTable::NoName;
+
+    /// \brief Checks if the given token is equal to the given word.
+    bool IsWord(const char* Token, std::size_t Length, const char* Word)
+    {
+        return Length == std::strlen(Word) && std::memcmp(Token, Word, Length) == 0;
+    }
+
+    /// \brief Creates an exception that reports the given error at the
+    /// given line.
+    std::invalid_argument LineError(std::size_t Line, const std::string& Message)
+    {
+        return std::invalid_argument("Line " + std::to_string(Line) + ": " + Message);
+    }
+}
+
+/// \brief Reads the automaton file at the given path. Throws an
+/// exception if the file cannot be read or is malformed.
+AutomatonReader::AutomatonReader(const std::string& Path)
+{
+    MappedFile file(Path);
+    this->Parse(file.getData(), file.getSize());
+}
+
+/// \brief Reads the automaton in the given buffer. Throws an
+/// exception if it is malformed.
+AutomatonReader::AutomatonReader(const char* Data, std::size_t Size)
+{
+    this->Parse(Data, Size);
+}
+
+/// \brief Parses the automaton in the given buffer.
+void AutomatonReader::Parse(const char* Data, std::size_t Size)
+{
+    Scanner scanner(Data, Size);
+    NameTable states;
+    NameTable symbols;
+    const char* token;
+    std::size_t length;
+
+    // Like AutomatonParser::ReadType, anything that is not a dfa or an
+    // nfa is read as an e-NFA.
+    if (!scanner.Next(token, length))
+        throw LineError(scanner.getLine(), "Expected an automaton type.");
+    const char* typeName;
+    const char* description;
+    if (IsWord(token, length, "dfa"))
+    {
+        this->type = AutomatonParser::Deterministic;
+        typeName = "dfa";
+        description = "a dfa";
+    }
+    else if (IsWord(token, length, "nfa"))
+    {
+        this->type = AutomatonParser::NonDeterministic;
+        typeName = "nfa";
+        description = "an nfa";
+    }
+    else
+    {
+        this->type = AutomatonParser::EpsilonNonDeterministic;
+        typeName = "enfa";
+        description = "an enfa";
+    }
+
+    bool hasStart = false;
+    while (scanner.Next(token, length))
+    {
+        if (IsWord(token, length, "start"))
+        {
+            if (!scanner.Next(token, length))
+                throw LineError(scanner.getLine(), "Expected a start state.");
+            this->startState = states.Intern(token, length);
+            hasStart = true;
+        }
+        else if (IsWord(token, length, "accepts"))
+        {
+            // The accepting states are the rest of the line.
+            while (scanner.NextOnLine(token, length))
+                this->acceptingStates.push_back(states.Intern(token, length));
+        }
+        else if (IsWord(token, length, "transitions"))
+        {
+            // Transitions run up to the end of the file.
+            while (scanner.Next(token, length))
+            {
+                auto source = states.Intern(token, length);
+                auto line = scanner.getLine();
+                const char* symbol;
+                std::size_t symbolLength;
+                if (!scanner.Next(symbol, symbolLength) || !scanner.Next(token, length))
+                    throw LineError(line, "Expected a symbol and a target state after state '"
+                                          + states.GetName(source) + "'.");
+                auto target = states.Intern(token, length);
+                if (this->type == AutomatonParser::EpsilonNonDeterministic && IsWord(symbol, symbolLength, "->"))
+                {
+                    this->epsilonEdges.push_back(source);
+                    this->epsilonEdges.push_back(target);
+                }
+                else
+                {
+                    this->edges.push_back(source);
+                    this->edges.push_back(symbols.Intern(symbol, symbolLength));
+                    this->edges.push_back(target);
+                }
+            }
+        }
+        else if (!IsWord(token, length, typeName))
+        {
+            throw LineError(scanner.getLine(), "Word '" + std::string(token, length)
+                                               + "' was not recognized while parsing " + description + ".");
+        }
+    }
+    if (!hasStart)
+        throw LineError(scanner.getLine(), "Expected a start state.");
+
+    this->stateCount = states.getCount();
+    std::vector<std::string> symbolNames;
+    symbolNames.reserve(symbols.getCount());
+    for (uint32_t i = 0; i < symbols.getCount(); i++)
+        symbolNames.push_back(symbols.GetName(i));
+    this->symbolTable = SymbolTable<std::string>(symbolNames);
+}
+
+/// \brief Creates a DFA from the automaton that has been read.
+/// NFAs and e-NFAs are determinized. A DFA's transitions that
+/// the file leaves undefined lead to the dead state.
+CompiledDFA<std::string> AutomatonReader::ToCompiledDFA() const
+{
+    if (this->type != AutomatonParser::Deterministic)
+        return this->ToCompiledNFA().Determinize();
+
+    // State ids are shifted by one to make room for the dead state.
+    // Later transitions for the same state and symbol override earlier
+    // ones.
+    auto stateCount = this->stateCount + 1;
+    auto rowLength = this->symbolTable.getCount() + 1;
+    std::vector<uint32_t> table((std::size_t)stateCount * rowLength, CompiledDFA<std::string>::DeadState);
+    for (std::size_t i = 0; i < this->edges.size(); i += 3)
+        table[(std::size_t)(this->edges[i] + 1) * rowLength + this->edges[i + 1]] = this->edges[i + 2] + 1;
+    std::vector<uint64_t> acceptBits((stateCount + 63) / 64, 0);
+    for (auto q : this->acceptingStates)
+        acceptBits[(q + 1) >> 6] |= (uint64_t)1 << ((q + 1) & 63);
+    return CompiledDFA<std::string>(this->symbolTable, stateCount, this->startState + 1, table, acceptBits);
+}
+
+/// \brief Creates an NFA from the automaton that has been read.
+/// Every type of automaton can be converted to an NFA.
+CompiledNFA<std::string> AutomatonReader::ToCompiledNFA() const
+{
+    return CompiledNFA<std::string>(this->symbolTable, this->stateCount, this->startState,
+                                    this->acceptingStates, this->edges, this->epsilonEdges);
+}
+
+/// \brief Gets the number of states that the automaton that has
+/// been read names.
+uint32_t AutomatonReader::getStateCount() const
+{
+    return this->stateCount;
+}
+
+/// \brief Gets the table of symbols that the automaton that has
+/// been read uses, numbered in order of first appearance.
+const SymbolTable<std::string>& AutomatonReader::getSymbolTable() const
+{
+    return this->symbolTable;
+}
+
+/// \brief Gets the type of the automaton that has been read.
+AutomatonParser::AutomatonType AutomatonReader::getType() const
+{
+    return this->type;
+}
\ No newline at end of file
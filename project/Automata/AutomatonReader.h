@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AutomatonParser.h"
+#include "CompiledDFA.h"
+#include "CompiledNFA.h"
+#include "SymbolTable.h"
+
+namespace Automata
+{
+    /// \brief Defines a reader that parses automaton files in the
+    /// format that AutomatonParser reads and writes, and builds their
+    /// integer-numbered form directly. The file is mapped into memory
+    /// and tokenized in place: state and symbol names are interned to
+    /// ids as they are scanned, without ever creating a string per
+    /// token, and edges are collected in flat arrays of ids.
+    /// Errors are reported with the number of the line they occur on.
+    class AutomatonReader
+    {
+    public:
+        /// \brief Reads the automaton file at the given path. Throws an
+        /// exception if the file cannot be read or is malformed.
+        AutomatonReader(const std::string& Path);
+
+        /// \brief Reads the automaton in the given buffer. Throws an
+        /// exception if it is malformed.
+        AutomatonReader(const char* Data, std::size_t Size);
+
+        /// \brief Creates a DFA from the automaton that has been read.
+        /// NFAs and e-NFAs are determinized. A DFA's transitions that
+        /// the file leaves undefined lead to the dead state.
+        CompiledDFA<std::string> ToCompiledDFA() const;
+
+        /// \brief Creates an NFA from the automaton that has been read.
+        /// Every type of automaton can be converted to an NFA.
+        CompiledNFA<std::string> ToCompiledNFA() const;
+
+        /// \brief Gets the number of states that the automaton that has
+        /// been read names.
+        uint32_t getStateCount() const;
+
+        /// \brief Gets the table of symbols that the automaton that has
+        /// been read uses, numbered in order of first appearance.
+        const SymbolTable<std::string>& getSymbolTable() const;
+
+        /// \brief Gets the type of the automaton that has been read.
+        AutomatonParser::AutomatonType getType() const;
+    private:
+        /// \brief Parses the automaton in the given buffer.
+        void Parse(const char* Data, std::size_t Size);
+
+        AutomatonParser::AutomatonType type;
+        SymbolTable<std::string> symbolTable;
+        uint32_t stateCount;
+        uint32_t startState;
+        std::vector<uint32_t> acceptingStates;
+        std::vector<uint32_t> edges;
+        std::vector<uint32_t> epsilonEdges;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "AutomatonWriter.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "CompiledDFA.h"
+#include "SubsetTable.h"
+
+using namespace Automata;
+
+const std::size_t AutomatonWriter::BufferSize;
+
+/// \brief Creates a writer that writes to the given stream.
+AutomatonWriter::AutomatonWriter(std::ostream& Output)
+    : output(Output)
+{
+    this->buffer.reserve(BufferSize);
+}
+
+/// \brief Writes any buffered output to the stream.
+AutomatonWriter::~AutomatonWriter()
+{
+    this->Flush();
+}
+
+/// \brief Writes any buffered output to the stream.
+void AutomatonWriter::Flush()
+{
+    this->output.write(this->buffer.data(), (std::streamsize)this->buffer.size());
+    this->buffer.clear();
+}
+
+/// \brief Writes the given automaton. Like DFAutomaton's text
+/// form, the automaton is complete: the dead state is written
+/// too, if it is reachable.
+void AutomatonWriter::Write(const CompiledDFA<std::string>& Value)
+{
+    std::vector<uint32_t> names;
+    auto order = OrderStates(Value, names);
+    auto& symbols = Value.getSymbols();
+
+    this->Append("dfa\nstart ", 10);
+    this->AppendState(0);
+    this->Append("\naccepts", 8);
+    for (uint32_t i = 0; i < order.size(); i++)
+    {
+        if (Value.IsAcceptingState(order[i]))
+        {
+            this->Append(" ", 1);
+            this->AppendState(i);
+        }
+    }
+    this->Append("\ntransitions\n", 13);
+    for (uint32_t i = 0; i < order.size(); i++)
+    {
+        for (uint32_t a = 0; a < symbols.size(); a++)
+        {
+            this->AppendState(i);
+            this->Append(" ", 1);
+            this->Append(symbols[a]);
+            this->Append(" ", 1);
+            this->AppendState(names[Value.PerformTransition(order[i], a)]);
+            this->Append("\n", 1);
+        }
+    }
+}
+
+/// \brief Writes the provenance of the given automaton's states:
+/// a line for every state that Write names, which lists the
+/// names of the states in the set with the same id in the given
+/// subset table. The item ids in the table are indices in the
+/// given vector of names.
+void AutomatonWriter::WriteSubsets(const CompiledDFA<std::string>& Value, const SubsetTable& Subsets, const std::vector<std::string>& Names)
+{
+    std::vector<uint32_t> names;
+    auto order = OrderStates(Value, names);
+    for (uint32_t i = 0; i < order.size(); i++)
+    {
+        this->AppendState(i);
+        this->Append(" {", 2);
+        auto items = Subsets.GetItems(order[i]);
+        auto size = Subsets.GetSize(order[i]);
+        for (uint32_t j = 0; j < size; j++)
+        {
+            if (j > 0)
+                this->Append(",", 1);
+            this->Append(Names[items[j]]);
+        }
+        this->Append("}\n", 2);
+    }
+}
+
+/// \brief Numbers the states of the given automaton that are
+/// reachable from its start state in breadth-first order, and
+/// returns the state ids in that order. Names is set to every
+/// state's number, or to CompiledDFA's NoState if it is not
+/// reachable.
+std::vector<uint32_t> AutomatonWriter::OrderStates(const CompiledDFA<std::string>& Value, std::vector<uint32_t>& Names)
+{
+    auto symbolCount = Value.getSymbolTable().getCount();
+    Names.assign(Value.getStateCount(), CompiledDFA<std::string>::NoState);
+    std::vector<uint32_t> order(1, Value.getStartState());
+    Names[Value.getStartState()] = 0;
+    // The order doubles as the breadth-first queue.
+    for (std::size_t i = 0; i < order.size(); i++)
+    {
+        for (uint32_t a = 0; a < symbolCount; a++)
+        {
+            auto target = Value.PerformTransition(order[i], a);
+            if (Names[target] == CompiledDFA<std::string>::NoState)
+            {
+                Names[target] = (uint32_t)order.size();
+                order.push_back(target);
+            }
+        }
+    }
+    return order;
+}
+
+/// \brief Appends the given bytes to the buffer.
+void AutomatonWriter::Append(const char* Data, std::size_t Length)
+{
+    if (this->buffer.size() + Length > BufferSize)
+        this->Flush();
+    this->buffer.append(Data, Length);
+}
+
+/// \brief Appends the given string to the buffer.
+void AutomatonWriter::Append(const std::string& Value)
+{
+    this->Append(Value.data(), Value.size());
+}
+
+/// \brief Appends the compact name of the state with the given
+/// number to the buffer.
+void AutomatonWriter::AppendState(uint32_t Number)
+{
+    char digits[11];
+    auto end = digits + sizeof(digits);
+    auto start = end;
+    do
+    {
+        *--start = (char)('0' + Number % 10);
+        Number /= 10;
+    } while (Number != 0);
+    *--start = 'q';
+    this->Append(start, (std::size_t)(end - start));
+}
\ No newline at end of file
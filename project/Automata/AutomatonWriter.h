@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "CompiledDFA.h"
+#include "SubsetTable.h"
+
+namespace Automata
+{
+    /// \brief Defines a writer that emits compiled DFAs in the format
+    /// that AutomatonParser reads, with compact state names: the
+    /// states that are reachable from the start state are named q0,
+    /// q1, ... in breadth-first order, starting with the start state.
+    /// Output is gathered in a large buffer, and is handed to the
+    /// underlying stream in bulk, without ever flushing it.
+    class AutomatonWriter
+    {
+    public:
+        /// \brief The number of bytes that are buffered before they are
+        /// written to the stream.
+        static const std::size_t BufferSize = 1 << 20;
+
+        /// \brief Creates a writer that writes to the given stream.
+        AutomatonWriter(std::ostream& Output);
+
+        AutomatonWriter(const AutomatonWriter&) = delete;
+        AutomatonWriter& operator=(const AutomatonWriter&) = delete;
+
+        /// \brief Writes any buffered output to the stream.
+        ~AutomatonWriter();
+
+        /// \brief Writes any buffered output to the stream.
+        void Flush();
+
+        /// \brief Writes the given automaton. Like DFAutomaton's text
+        /// form, the automaton is complete: the dead state is written
+        /// too, if it is reachable.
+        void Write(const CompiledDFA<std::string>& Value);
+
+        /// \brief Writes the provenance of the given automaton's states:
+        /// a line for every state that Write names, which lists the
+        /// names of the states in the set with the same id in the given
+        /// subset table. The item ids in the table are indices in the
+        /// given vector of names.
+        void WriteSubsets(const CompiledDFA<std::string>& Value, const SubsetTable& Subsets, const std::vector<std::string>& Names);
+    private:
+        /// \brief Numbers the states of the given automaton that are
+        /// reachable from its start state in breadth-first order, and
+        /// returns the state ids in that order. Names is set to every
+        /// state's number, or to CompiledDFA's NoState if it is not
+        /// reachable.
+        static std::vector<uint32_t> OrderStates(const CompiledDFA<std::string>& Value, std::vector<uint32_t>& Names);
+
+        /// \brief Appends the given bytes to the buffer.
+        void Append(const char* Data, std::size_t Length);
+
+        /// \brief Appends the given string to the buffer.
+        void Append(const std::string& Value);
+
+        /// \brief Appends the compact name of the state with the given
+        /// number to the buffer.
+        void AppendState(uint32_t Number);
+
+        std::ostream& output;
+        std::string buffer;
+    };
+}
\ No newline at end of file
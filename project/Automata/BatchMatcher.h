@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "CompiledDFA.h"
+#include "CompiledNFA.h"
+#include "LazyDFA.h"
+#include "LockstepRunner.h"
+#include "Prefilter.h"
+
+namespace Automata
+{
+    /// \brief Defines a matcher that tests large batches of byte
+    /// strings against a single automaton, and spreads every batch
+    /// over a number of worker threads. Each worker tests a contiguous
+    /// range of the batch, so results can be written in input order.
+    /// The compiled automaton is shared by all workers and is never
+    /// modified. NFAs are simulated by a lazy DFA per worker, which is
+    /// that worker's scratch space; it is kept from one batch to the
+    /// next, so its cache stays warm. DFA matchers first check that
+    /// a string contains a literal that every accepted string
+    /// contains, which rejects most strings without running the
+    /// automaton. The remaining strings are collected in the worker's
+    /// scratch space, and run through a lockstep kernel that advances
+    /// several of them at once. A batch matcher must not be used
+    /// by more than one thread at a time.
+    template<typename TChar>
+    class BatchMatcher
+    {
+    public:
+        /// \brief The smallest number of strings per worker: smaller
+        /// batches use fewer workers.
+        static const std::size_t MinStringsPerThread = 1024;
+
+        /// \brief Creates a batch matcher for the given DFA that uses the
+        /// given number of worker threads, or one worker per hardware
+        /// thread if the given number is zero.
+        BatchMatcher(std::shared_ptr<const CompiledDFA<TChar>> Automaton, unsigned ThreadCount);
+
+        /// \brief Creates a batch matcher for the given NFA or e-NFA that
+        /// uses the given number of worker threads, or one worker per
+        /// hardware thread if the given number is zero.
+        BatchMatcher(std::shared_ptr<const CompiledNFA<TChar>> Automaton, unsigned ThreadCount);
+
+        /// \brief Tests the strings in the given buffer: string i is the
+        /// range [Starts[i], Ends[i]). Result i is set to one if the
+        /// automaton accepts string i, and to zero otherwise.
+        void Accepts(const char* Data, const std::vector<std::size_t>& Starts, const std::vector<std::size_t>& Ends, std::vector<uint8_t>& Results);
+
+        /// \brief Gets the prefilter that rejects strings before they
+        /// are matched.
+        const Prefilter& getPrefilter() const;
+
+        /// \brief Gets the number of worker threads.
+        unsigned getThreadCount() const;
+    private:
+        /// \brief Describes a worker's scratch space: the strings that
+        /// pass the prefilter, their indices in the batch, and the
+        /// states the DFA ends up in for them.
+        struct Scratch
+        {
+            std::vector<std::size_t> Starts;
+            std::vector<std::size_t> Ends;
+            std::vector<std::size_t> Indices;
+            std::vector<uint32_t> States;
+        };
+
+        /// \brief Tests the strings in the range [First, Last) of the
+        /// batch on behalf of the worker with the given index.
+        void AcceptsRange(unsigned Worker, const char* Data, const std::vector<std::size_t>& Starts, const std::vector<std::size_t>& Ends, std::size_t First, std::size_t Last, std::vector<uint8_t>& Results);
+
+        /// \brief Gets the number of worker threads to use if zero is
+        /// given.
+        static unsigned GetDefaultThreadCount();
+
+        std::shared_ptr<const CompiledDFA<TChar>> dfa;
+        std::unique_ptr<LockstepRunner> runner;
+        std::vector<Scratch> scratch;
+        std::vector<std::unique_ptr<LazyDFA<TChar>>> lazyDfas;
+        Prefilter prefilter;
+        unsigned threadCount;
+    };
+}
+
+#include "BatchMatcher.hxx"
\ No newline at end of file
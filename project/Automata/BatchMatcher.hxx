@@ -0,0 +1,123 @@
+#include "BatchMatcher.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "CompiledDFA.h"
+#include "CompiledNFA.h"
+#include "LazyDFA.h"
+#include "LockstepRunner.h"
+#include "Prefilter.h"
+
+using namespace Automata;
+
+template<typename TChar>
+const std::size_t BatchMatcher<TChar>::MinStringsPerThread;
+
+/// \brief Creates a batch matcher for the given DFA that uses the
+/// given number of worker threads, or one worker per hardware
+/// thread if the given number is zero.
+template<typename TChar>
+BatchMatcher<TChar>::BatchMatcher(std::shared_ptr<const CompiledDFA<TChar>> Automaton, unsigned ThreadCount)
+    : dfa(Automaton), threadCount(ThreadCount == 0 ? GetDefaultThreadCount() : ThreadCount)
+{
+    bool isPrefix;
+    auto literal = Automaton->FindRequiredLiteral(isPrefix);
+    this->prefilter = Prefilter(literal, isPrefix);
+    this->runner.reset(new LockstepRunner(Automaton->getTransitions().data(), Automaton->getStateCount(),
+                                          Automaton->getRowLength(), Automaton->getByteColumns(), Automaton->getStartState()));
+    this->scratch.resize(this->threadCount);
+}
+
+/// \brief Creates a batch matcher for the given NFA or e-NFA that
+/// uses the given number of worker threads, or one worker per
+/// hardware thread if the given number is zero.
+template<typename TChar>
+BatchMatcher<TChar>::BatchMatcher(std::shared_ptr<const CompiledNFA<TChar>> Automaton, unsigned ThreadCount)
+    : threadCount(ThreadCount == 0 ? GetDefaultThreadCount() : ThreadCount)
+{
+    for (unsigned i = 0; i < this->threadCount; i++)
+        this->lazyDfas.push_back(std::unique_ptr<LazyDFA<TChar>>(new LazyDFA<TChar>(Automaton)));
+}
+
+/// \brief Tests the strings in the given buffer: string i is the
+/// range [Starts[i], Ends[i]). Result i is set to one if the
+/// automaton accepts string i, and to zero otherwise.
+template<typename TChar>
+void BatchMatcher<TChar>::Accepts(const char* Data, const std::vector<std::size_t>& Starts, const std::vector<std::size_t>& Ends, std::vector<uint8_t>& Results)
+{
+    auto count = Starts.size();
+    Results.resize(count);
+    auto workers = (unsigned)std::min<std::size_t>(this->threadCount, std::max<std::size_t>(1, count / MinStringsPerThread));
+    auto work = [&](unsigned Worker)
+    {
+        this->AcceptsRange(Worker, Data, Starts, Ends, count * Worker / workers, count * (Worker + 1) / workers, Results);
+    };
+
+    // The calling thread takes the first range itself.
+    std::vector<std::thread> threads;
+    for (unsigned w = 1; w < workers; w++)
+        threads.push_back(std::thread(work, w));
+    work(0);
+    for (auto& thread : threads)
+        thread.join();
+}
+
+/// \brief Tests the strings in the range [First, Last) of the
+/// batch on behalf of the worker with the given index.
+template<typename TChar>
+void BatchMatcher<TChar>::AcceptsRange(unsigned Worker, const char* Data, const std::vector<std::size_t>& Starts, const std::vector<std::size_t>& Ends, std::size_t First, std::size_t Last, std::vector<uint8_t>& Results)
+{
+    if (!this->dfa)
+    {
+        auto& lazyDfa = *this->lazyDfas[Worker];
+        for (auto i = First; i < Last; i++)
+            Results[i] = lazyDfa.Accepts(Data + Starts[i], Ends[i] - Starts[i]) ? 1 : 0;
+        return;
+    }
+
+    auto& scratch = this->scratch[Worker];
+    scratch.Starts.clear();
+    scratch.Ends.clear();
+    scratch.Indices.clear();
+    for (auto i = First; i < Last; i++)
+    {
+        Results[i] = 0;
+        if (this->prefilter.MayAccept(Data + Starts[i], Ends[i] - Starts[i]))
+        {
+            scratch.Starts.push_back(Starts[i]);
+            scratch.Ends.push_back(Ends[i]);
+            scratch.Indices.push_back(i);
+        }
+    }
+    scratch.States.resize(scratch.Indices.size());
+    this->runner->Run(Data, scratch.Starts.data(), scratch.Ends.data(), scratch.Indices.size(), scratch.States.data());
+    for (std::size_t k = 0; k < scratch.Indices.size(); k++)
+        Results[scratch.Indices[k]] = this->dfa->IsAcceptingState(scratch.States[k]) ? 1 : 0;
+}
+
+/// \brief Gets the number of worker threads to use if zero is
+/// given.
+template<typename TChar>
+unsigned BatchMatcher<TChar>::GetDefaultThreadCount()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/// \brief Gets the prefilter that rejects strings before they
+/// are matched.
+template<typename TChar>
+const Prefilter& BatchMatcher<TChar>::getPrefilter() const
+{
+    return this->prefilter;
+}
+
+/// \brief Gets the number of worker threads.
+template<typename TChar>
+unsigned BatchMatcher<TChar>::getThreadCount() const
+{
+    return this->threadCount;
+}
\ No newline at end of file
@@ -1,9 +1,10 @@
 #pragma once
+#include <cstddef>
 #include <memory>
 #include <string>
 #include "ENFAutomaton.h"
 #include "IRegex.h"
-#include "RegexState.h"
+#include "ThompsonBuilder.h"
 
 namespace Automata
 {
@@ -15,22 +16,29 @@ namespace Automata
         /// \brief Creates a new closure regex from the given regex.
         ClosureRegex(std::shared_ptr<IRegex> Regex);
 
-        /// \brief Creates an epsilon-nfa for this closure regex.
-        /// The construction is as follows:   * An automaton is
-        /// constructed for the closure regex' inner regex.
-        /// * A new start state and a single accepting state are
-        /// created.   * An automaton is created that consists of:
-        /// * The inner regex' automaton     * The new start and
-        /// accepting states     * epsilon transitions that connect the
-        /// inner automaton's start and       end states with the new
-        /// automaton's start and end states.
-        /// Also, a "loop" is created to facilitate the closure.
-        ENFAutomaton<std::shared_ptr<RegexState>, std::string> ToENFAutomaton() const override;
+        /// \brief Appends this closure regex's e-NFA to the given builder.
+        /// The construction is as follows:
+        /// * A fragment is appended for the closure regex' inner regex.
+        /// * A new start state and a new accepting state are created.
+        /// * Epsilon-transitions go from the new start state and from the
+        ///   inner fragment's accepting state to both the inner fragment's
+        ///   start state and the new accepting state.
+        /// Thus, a "loop" is created to facilitate the closure.
+        RegexFragment AppendENFAutomaton(ThompsonBuilder& Builder) const override;
 
         /// \brief Gets this regex's string representation.
         std::string ToString() const override;
 
+        /// \brief Gets this regex's hash code, which depends on its
+        /// structure only, and is computed when the regex is created.
+        std::size_t getHashCode() const override;
+
+        /// \brief Gets this regex's kind.
+        RegexKind getKind() const override;
+
         /// \brief The closure regex' inner regex.
         std::shared_ptr<IRegex> Regex;
+    private:
+        std::size_t hashCode;
     };
 }
\ No newline at end of file
@@ -0,0 +1,189 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ArraySlice.h"
+#include "IAutomaton.h"
+#include "SymbolTable.h"
+
+namespace Automata
+{
+    template<typename TState, typename TChar>
+    class DFAutomaton;
+
+    /// \brief Defines a deterministic finite automaton whose states and
+    /// symbols have been numbered, and whose transition function is
+    /// stored as a dense, row-major table of state ids.
+    /// State zero is the dead state: it rejects every string, and all
+    /// transitions that the source automaton left undefined lead to it.
+    /// Every row has one extra column after the alphabet's symbols,
+    /// which handles symbols that are not in the alphabet. Raw byte
+    /// strings can be matched directly: every byte is treated as the
+    /// single-byte symbol that consists of it.
+    template<typename TChar>
+    class CompiledDFA : public virtual IAutomaton<TChar>
+    {
+    public:
+        /// \brief The id of the dead state.
+        static const uint32_t DeadState = 0;
+
+        /// \brief A state id that denotes the absence of a state, such as
+        /// the image of an unreachable state under minimization.
+        static const uint32_t NoState = 0xFFFFFFFF;
+
+        /// \brief Creates an empty compiled automaton, which consists of
+        /// the dead state only.
+        CompiledDFA();
+
+        /// \brief Creates a compiled automaton from the given alphabet,
+        /// state count, start state, row-major transition table and
+        /// accepting state bitmap. The transition table must contain
+        /// StateCount rows of (Symbols.getCount() + 1) entries each.
+        CompiledDFA(SymbolTable<TChar> Symbols, uint32_t StateCount, uint32_t StartState, std::vector<uint32_t> Transitions, std::vector<uint64_t> AcceptingStates);
+
+        /// \brief Checks if this automaton accepts the given string of
+        /// symbols.
+        bool Accepts(stdx::ArraySlice<TChar> Characters) const override;
+
+        /// \brief Checks if this automaton accepts the given string of
+        /// symbol ids.
+        bool Accepts(const uint32_t* Symbols, std::size_t Length) const;
+
+        /// \brief Checks if this automaton accepts the given string of
+        /// bytes.
+        bool Accepts(const char* Data, std::size_t Length) const;
+
+        /// \brief Finds a string of single-byte symbols that every string
+        /// this automaton accepts contains, and that is as long as
+        /// possible. IsPrefix is set if every accepted string starts
+        /// with it. Returns an empty string if there is no such string,
+        /// or if it could not be found.
+        std::string FindRequiredLiteral(bool& IsPrefix) const;
+
+        /// \brief Gets the id of the given symbol. Symbols that are not in
+        /// this automaton's alphabet are mapped to the "other" symbol.
+        uint32_t GetSymbolId(const TChar& Character) const;
+
+        /// \brief Applies Hopcroft's partition refinement algorithm to
+        /// all states of this automaton, and returns the resulting
+        /// partition as a block id for every state. Two states are in
+        /// the same block if and only if they are equivalent. Blocks
+        /// are numbered in order of their smallest state id, so the
+        /// dead state is always in block zero.
+        std::vector<uint32_t> HopcroftPartition() const;
+
+        /// \brief Finds out if the state with the given id is an accepting
+        /// state.
+        bool IsAcceptingState(uint32_t State) const;
+
+        /// \brief Computes the minimal automaton that is equivalent to
+        /// this automaton. Unreachable states are discarded, and the
+        /// remaining states are merged by Hopcroft's algorithm.
+        CompiledDFA<TChar> Minimize() const;
+
+        /// \brief Computes the minimal automaton that is equivalent to
+        /// this automaton, and stores the minimal automaton's state
+        /// for every state of this automaton in the given vector.
+        /// Unreachable states are mapped to NoState.
+        CompiledDFA<TChar> Minimize(std::vector<uint32_t>& StateMap) const;
+
+        /// \brief Computes the minimal automaton that is equivalent to
+        /// this automaton, without merging states that have different
+        /// labels, and stores the minimal automaton's state for every
+        /// state of this automaton in the given vector. The labels must
+        /// distinguish accepting states from non-accepting ones.
+        CompiledDFA<TChar> Minimize(const std::vector<uint32_t>& Labels, std::vector<uint32_t>& StateMap) const;
+
+        /// \brief Applies the automaton's extended transition function to
+        /// the given state and string of symbol ids.
+        uint32_t PerformExtendedTransition(uint32_t State, const uint32_t* Symbols, std::size_t Length) const;
+
+        /// \brief Applies the automaton's extended transition function to
+        /// the given state and string of bytes.
+        uint32_t PerformExtendedTransition(uint32_t State, const char* Data, std::size_t Length) const;
+
+        /// \brief Applies the automaton's transition function to the given
+        /// state and symbol id.
+        uint32_t PerformTransition(uint32_t State, uint32_t Symbol) const;
+
+        /// \brief Gets the states that are reachable from the start state,
+        /// as a vector of flags indexed by state id. The dead state is
+        /// always considered reachable.
+        std::vector<bool> ReachableStates() const;
+
+        /// \brief Creates a DFA whose states are named by the given
+        /// vector, which is indexed by state id. Only states that are
+        /// reachable from the start state by the alphabet's symbols are
+        /// included, so the dead state only appears if some defined
+        /// transition leads to it.
+        template<typename TState>
+        DFAutomaton<TState, TChar> ToDFAutomaton(const std::vector<TState>& States) const;
+
+        /// \brief Converts the given string of symbols to a string of
+        /// symbol ids.
+        std::vector<uint32_t> TranslateSymbols(stdx::ArraySlice<TChar> Characters) const;
+
+        /// \brief Gets the accepting state bitmap. Bit (i % 64) of word
+        /// (i / 64) is set if state i is an accepting state.
+        const std::vector<uint64_t>& getAcceptingStates() const;
+
+        /// \brief Gets the 256-entry table that maps every byte to the
+        /// column of the single-byte symbol that consists of it.
+        const uint32_t* getByteColumns() const;
+
+        /// \brief Gets the id of the "other" symbol, which stands for
+        /// every symbol that is not in this automaton's alphabet.
+        uint32_t getOtherSymbol() const;
+
+        /// \brief Gets the number of entries in a single row of the
+        /// transition table.
+        uint32_t getRowLength() const;
+
+        /// \brief Gets this automaton's start state.
+        uint32_t getStartState() const;
+
+        /// \brief Gets the number of states in this automaton, including
+        /// the dead state.
+        uint32_t getStateCount() const;
+
+        /// \brief Gets this automaton's alphabet. A symbol's id is its
+        /// index in this vector.
+        const std::vector<TChar>& getSymbols() const;
+
+        /// \brief Gets the table that assigns this automaton's symbols
+        /// their ids.
+        const SymbolTable<TChar>& getSymbolTable() const;
+
+        /// \brief Gets the row-major transition table.
+        const std::vector<uint32_t>& getTransitions() const;
+    private:
+        /// \brief The maximal length of the literals that
+        /// FindRequiredLiteral finds.
+        static const std::size_t MaxLiteralLength = 64;
+
+        /// \brief The maximal number of transitions that
+        /// FindRequiredLiteral may inspect.
+        static const std::size_t MaxLiteralWork = 1 << 26;
+
+        /// \brief Checks if every accepted string contains the given
+        /// literal. The work is charged against the given budget; the
+        /// literal is not considered required once the budget runs out.
+        bool IsRequiredLiteral(const std::string& Literal, const std::vector<bool>& Live, std::size_t& Budget) const;
+
+        /// \brief Refines the given initial partition until all states
+        /// in every block are equivalent, and returns the refined block
+        /// id of every state. States in block NoState are ignored; they
+        /// must not be reachable from the other states.
+        std::vector<uint32_t> RefinePartition(std::vector<uint32_t> Blocks) const;
+
+        SymbolTable<TChar> symbolTable;
+        std::vector<uint32_t> byteColumns;
+        uint32_t stateCount;
+        uint32_t startState;
+        std::vector<uint32_t> transitions;
+        std::vector<uint64_t> acceptingStates;
+    };
+}
+
+#include "CompiledDFA.hxx"
\ No newline at end of file
@@ -0,0 +1,713 @@
+#include "CompiledDFA.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "ArraySlice.h"
+#include "IAutomaton.h"
+#include "LinearSet.h"
+#include "SymbolTable.h"
+#include "TransitionTable.h"
+
+using namespace Automata;
+
+template<typename TChar>
+const uint32_t CompiledDFA<TChar>::DeadState;
+
+template<typename TChar>
+const uint32_t CompiledDFA<TChar>::NoState;
+
+template<typename TChar>
+const std::size_t CompiledDFA<TChar>::MaxLiteralLength;
+
+template<typename TChar>
+const std::size_t CompiledDFA<TChar>::MaxLiteralWork;
+
+/// \brief Creates an empty compiled automaton, which consists of
+/// the dead state only.
+template<typename TChar>
+CompiledDFA<TChar>::CompiledDFA()
+    : byteColumns(256, 0), stateCount(1), startState(DeadState),
+      transitions(1, DeadState), acceptingStates(1, 0)
+{ }
+
+/// \brief Creates a compiled automaton from the given alphabet,
+/// state count, start state, row-major transition table and
+/// accepting state bitmap. The transition table must contain
+/// StateCount rows of (Symbols.getCount() + 1) entries each.
+template<typename TChar>
+CompiledDFA<TChar>::CompiledDFA(SymbolTable<TChar> Symbols, uint32_t StateCount, uint32_t StartState, std::vector<uint32_t> Transitions, std::vector<uint64_t> AcceptingStates)
+    : symbolTable(Symbols), byteColumns(256), stateCount(StateCount), startState(StartState),
+      transitions(Transitions), acceptingStates(AcceptingStates)
+{
+    for (uint32_t b = 0; b < 256; b++)
+    {
+        auto id = this->symbolTable.GetByteId((unsigned char)b);
+        this->byteColumns[b] = id == SymbolTable<TChar>::NoSymbol ? this->getOtherSymbol() : id;
+    }
+    this->acceptingStates.resize((StateCount + 63) / 64, 0);
+}
+
+/// \brief Checks if this automaton accepts the given string of
+/// symbols.
+template<typename TChar>
+bool CompiledDFA<TChar>::Accepts(stdx::ArraySlice<TChar> Characters) const
+{
+    auto rowLength = this->getRowLength();
+    auto table = this->transitions.data();
+    auto state = this->startState;
+    for (auto& item : Characters)
+        state = table[(std::size_t)state * rowLength + this->GetSymbolId(item)];
+    return this->IsAcceptingState(state);
+}
+
+/// \brief Checks if this automaton accepts the given string of
+/// symbol ids.
+template<typename TChar>
+bool CompiledDFA<TChar>::Accepts(const uint32_t* Symbols, std::size_t Length) const
+{
+    return this->IsAcceptingState(this->PerformExtendedTransition(this->startState,
+                                                                  Symbols, Length));
+}
+
+/// \brief Checks if this automaton accepts the given string of
+/// bytes.
+template<typename TChar>
+bool CompiledDFA<TChar>::Accepts(const char* Data, std::size_t Length) const
+{
+    return this->IsAcceptingState(this->PerformExtendedTransition(this->startState,
+                                                                  Data, Length));
+}
+
+/// \brief Finds a string of single-byte symbols that every string
+/// this automaton accepts contains, and that is as long as
+/// possible. IsPrefix is set if every accepted string starts
+/// with it. Returns an empty string if there is no such string,
+/// or if it could not be found.
+/// The prefix is the forced path out of the start state: as long
+/// as a string is in a state that is not accepting and has a single
+/// live transition, it must continue with that transition's symbol.
+/// Other literals are grown one byte at a time from the bytes that
+/// are required on their own, for as long as the analysis stays
+/// within its work budget.
+template<typename TChar>
+std::string CompiledDFA<TChar>::FindRequiredLiteral(bool& IsPrefix) const
+{
+    IsPrefix = false;
+    auto rowLength = this->getRowLength();
+
+    // Live states are the states from which an accepting state can be
+    // reached.
+    std::vector<std::vector<uint32_t>> predecessors(this->stateCount);
+    for (uint32_t q = 0; q < this->stateCount; q++)
+        for (uint32_t a = 0; a < rowLength; a++)
+            predecessors[this->PerformTransition(q, a)].push_back(q);
+    std::vector<bool> live(this->stateCount, false);
+    std::vector<uint32_t> todo;
+    for (uint32_t q = 0; q < this->stateCount; q++)
+    {
+        if (this->IsAcceptingState(q))
+        {
+            live[q] = true;
+            todo.push_back(q);
+        }
+    }
+    while (!todo.empty())
+    {
+        auto q = todo.back();
+        todo.pop_back();
+        for (auto p : predecessors[q])
+        {
+            if (!live[p])
+            {
+                live[p] = true;
+                todo.push_back(p);
+            }
+        }
+    }
+    if (!live[this->startState])
+        return std::string();
+
+    std::string prefix;
+    std::vector<bool> visited(this->stateCount, false);
+    auto q = this->startState;
+    while (!this->IsAcceptingState(q) && !visited[q] && prefix.size() < MaxLiteralLength)
+    {
+        visited[q] = true;
+        auto column = NoState;
+        for (uint32_t a = 0; a < rowLength; a++)
+        {
+            if (!live[this->PerformTransition(q, a)])
+                continue;
+            if (column != NoState)
+            {
+                column = NoState;
+                break;
+            }
+            column = a;
+        }
+        unsigned char byte;
+        if (column == NoState || column == this->getOtherSymbol()
+            || !TryGetSymbolByte(this->symbolTable.GetSymbol(column), byte))
+            break;
+        prefix.push_back((char)byte);
+        q = this->PerformTransition(q, column);
+    }
+
+    std::vector<char> bytes;
+    for (uint32_t a = 0; a < this->getOtherSymbol(); a++)
+    {
+        unsigned char byte;
+        if (TryGetSymbolByte(this->symbolTable.GetSymbol(a), byte))
+            bytes.push_back((char)byte);
+    }
+    std::string best;
+    std::size_t budget = MaxLiteralWork;
+    for (auto byte : bytes)
+    {
+        std::string literal(1, byte);
+        if (best.find(byte) != std::string::npos || !this->IsRequiredLiteral(literal, live, budget))
+            continue;
+        bool grown = true;
+        while (grown && literal.size() < MaxLiteralLength)
+        {
+            grown = false;
+            for (auto next : bytes)
+            {
+                if (this->IsRequiredLiteral(literal + next, live, budget))
+                {
+                    literal.push_back(next);
+                    grown = true;
+                    break;
+                }
+                if (this->IsRequiredLiteral(next + literal, live, budget))
+                {
+                    literal.insert(literal.begin(), next);
+                    grown = true;
+                    break;
+                }
+            }
+        }
+        if (literal.size() > best.size())
+            best = literal;
+    }
+
+    if (!prefix.empty() && prefix.size() >= best.size())
+    {
+        IsPrefix = true;
+        return prefix;
+    }
+    return best;
+}
+
+/// \brief Gets the id of the given symbol. Symbols that are not in
+/// this automaton's alphabet are mapped to the "other" symbol.
+template<typename TChar>
+uint32_t CompiledDFA<TChar>::GetSymbolId(const TChar& Character) const
+{
+    auto id = this->symbolTable.GetId(Character);
+    return id == SymbolTable<TChar>::NoSymbol ? this->getOtherSymbol() : id;
+}
+
+/// \brief Applies Hopcroft's partition refinement algorithm to
+/// all states of this automaton, and returns the resulting
+/// partition as a block id for every state. Two states are in
+/// the same block if and only if they are equivalent. Blocks
+/// are numbered in order of their smallest state id, so the
+/// dead state is always in block zero.
+template<typename TChar>
+std::vector<uint32_t> CompiledDFA<TChar>::HopcroftPartition() const
+{
+    std::vector<uint32_t> blocks(this->stateCount);
+    for (uint32_t q = 0; q < this->stateCount; q++)
+        blocks[q] = this->IsAcceptingState(q) ? 1 : 0;
+    return this->RefinePartition(blocks);
+}
+
+/// \brief Finds out if the state with the given id is an accepting
+/// state.
+template<typename TChar>
+bool CompiledDFA<TChar>::IsAcceptingState(uint32_t State) const
+{
+    return ((this->acceptingStates[State >> 6] >> (State & 63)) & 1) != 0;
+}
+
+/// \brief Checks if every accepted string contains the given
+/// literal, by searching the product of this automaton and the
+/// literal's Knuth-Morris-Pratt automaton for an accepting state
+/// that can be reached without completing the literal. Only live
+/// states are searched. The work is charged against the given
+/// budget; the literal is not considered required once the
+/// budget runs out.
+template<typename TChar>
+bool CompiledDFA<TChar>::IsRequiredLiteral(const std::string& Literal, const std::vector<bool>& Live, std::size_t& Budget) const
+{
+    auto size = (uint32_t)Literal.size();
+    auto rowLength = this->getRowLength();
+    if (Budget < (std::size_t)this->stateCount * size * rowLength)
+    {
+        Budget = 0;
+        return false;
+    }
+
+    // The matcher state is the length of the longest prefix of the
+    // literal that the input ends with.
+    std::vector<uint32_t> failure(size + 1, 0);
+    for (uint32_t i = 1, k = 0; i < size; i++)
+    {
+        while (k > 0 && Literal[i] != Literal[k])
+            k = failure[k];
+        if (Literal[i] == Literal[k])
+            k++;
+        failure[i + 1] = k;
+    }
+    std::vector<uint32_t> matcher((std::size_t)size * rowLength, 0);
+    for (uint32_t a = 0; a < this->getOtherSymbol(); a++)
+    {
+        unsigned char byte;
+        if (!TryGetSymbolByte(this->symbolTable.GetSymbol(a), byte))
+            continue;
+        for (uint32_t j = 0; j < size; j++)
+        {
+            auto k = j;
+            while (k > 0 && (unsigned char)Literal[k] != byte)
+                k = failure[k];
+            matcher[(std::size_t)j * rowLength + a] = (unsigned char)Literal[k] == byte ? k + 1 : 0;
+        }
+    }
+
+    std::vector<bool> visited((std::size_t)this->stateCount * size, false);
+    std::vector<std::pair<uint32_t, uint32_t>> todo;
+    visited[(std::size_t)this->startState * size] = true;
+    todo.push_back(std::make_pair(this->startState, 0));
+    while (!todo.empty())
+    {
+        auto q = todo.back().first;
+        auto j = todo.back().second;
+        todo.pop_back();
+        if (this->IsAcceptingState(q))
+            return false;
+        Budget -= std::min<std::size_t>(Budget, rowLength);
+        for (uint32_t a = 0; a < rowLength; a++)
+        {
+            auto target = this->PerformTransition(q, a);
+            auto k = matcher[(std::size_t)j * rowLength + a];
+            if (!Live[target] || k == size || visited[(std::size_t)target * size + k])
+                continue;
+            visited[(std::size_t)target * size + k] = true;
+            todo.push_back(std::make_pair(target, k));
+        }
+    }
+    return true;
+}
+
+/// \brief Computes the minimal automaton that is equivalent to
+/// this automaton. Unreachable states are discarded, and the
+/// remaining states are merged by Hopcroft's algorithm.
+template<typename TChar>
+CompiledDFA<TChar> CompiledDFA<TChar>::Minimize() const
+{
+    std::vector<uint32_t> stateMap;
+    return this->Minimize(stateMap);
+}
+
+/// \brief Computes the minimal automaton that is equivalent to
+/// this automaton, and stores the minimal automaton's state
+/// for every state of this automaton in the given vector.
+/// Unreachable states are mapped to NoState.
+template<typename TChar>
+CompiledDFA<TChar> CompiledDFA<TChar>::Minimize(std::vector<uint32_t>& StateMap) const
+{
+    std::vector<uint32_t> labels(this->stateCount);
+    for (uint32_t q = 0; q < this->stateCount; q++)
+        labels[q] = this->IsAcceptingState(q) ? 1 : 0;
+    return this->Minimize(labels, StateMap);
+}
+
+/// \brief Computes the minimal automaton that is equivalent to
+/// this automaton, without merging states that have different
+/// labels, and stores the minimal automaton's state for every
+/// state of this automaton in the given vector. The labels must
+/// distinguish accepting states from non-accepting ones.
+template<typename TChar>
+CompiledDFA<TChar> CompiledDFA<TChar>::Minimize(const std::vector<uint32_t>& Labels, std::vector<uint32_t>& StateMap) const
+{
+    auto reachable = this->ReachableStates();
+    std::vector<uint32_t> blocks(this->stateCount, NoState);
+    for (uint32_t q = 0; q < this->stateCount; q++)
+        if (reachable[q])
+            blocks[q] = Labels[q];
+    // Refined blocks are numbered by their smallest member, so they
+    // can serve as state ids directly: the dead state's block is zero.
+    StateMap = this->RefinePartition(blocks);
+    uint32_t newStateCount = 0;
+    for (auto block : StateMap)
+        if (block != NoState)
+            newStateCount = std::max(newStateCount, block + 1);
+
+    auto rowLength = this->getRowLength();
+    std::vector<uint32_t> newTable((std::size_t)newStateCount * rowLength, DeadState);
+    std::vector<uint64_t> newAccepting((newStateCount + 63) / 64, 0);
+    for (uint32_t q = 0; q < this->stateCount; q++)
+    {
+        auto block = StateMap[q];
+        if (block == NoState)
+            continue;
+        for (uint32_t a = 0; a < rowLength; a++)
+            newTable[(std::size_t)block * rowLength + a] = StateMap[this->PerformTransition(q, a)];
+        if (this->IsAcceptingState(q))
+            newAccepting[block >> 6] |= (uint64_t)1 << (block & 63);
+    }
+    return CompiledDFA<TChar>(this->symbolTable, newStateCount, StateMap[this->startState],
+                              newTable, newAccepting);
+}
+
+/// \brief Applies the automaton's extended transition function to
+/// the given state and string of symbol ids.
+template<typename TChar>
+uint32_t CompiledDFA<TChar>::PerformExtendedTransition(uint32_t State, const uint32_t* Symbols, std::size_t Length) const
+{
+    auto rowLength = this->getRowLength();
+    auto table = this->transitions.data();
+    for (std::size_t i = 0; i < Length; i++)
+        State = table[(std::size_t)State * rowLength + Symbols[i]];
+    return State;
+}
+
+/// \brief Applies the automaton's extended transition function to
+/// the given state and string of bytes.
+template<typename TChar>
+uint32_t CompiledDFA<TChar>::PerformExtendedTransition(uint32_t State, const char* Data, std::size_t Length) const
+{
+    auto rowLength = this->getRowLength();
+    auto table = this->transitions.data();
+    auto columns = this->byteColumns.data();
+    for (std::size_t i = 0; i < Length; i++)
+        State = table[(std::size_t)State * rowLength + columns[(unsigned char)Data[i]]];
+    return State;
+}
+
+/// \brief Applies the automaton's transition function to the given
+/// state and symbol id.
+template<typename TChar>
+uint32_t CompiledDFA<TChar>::PerformTransition(uint32_t State, uint32_t Symbol) const
+{
+    return this->transitions[(std::size_t)State * this->getRowLength() + Symbol];
+}
+
+/// \brief Gets the states that are reachable from the start state,
+/// as a vector of flags indexed by state id. The dead state is
+/// always considered reachable.
+template<typename TChar>
+std::vector<bool> CompiledDFA<TChar>::ReachableStates() const
+{
+    std::vector<bool> reachable(this->stateCount, false);
+    std::vector<uint32_t> todo;
+    reachable[DeadState] = true;
+    reachable[this->startState] = true;
+    todo.push_back(this->startState);
+    auto rowLength = this->getRowLength();
+    while (!todo.empty())
+    {
+        auto q = todo.back();
+        todo.pop_back();
+        for (uint32_t a = 0; a < rowLength; a++)
+        {
+            auto target = this->PerformTransition(q, a);
+            if (!reachable[target])
+            {
+                reachable[target] = true;
+                todo.push_back(target);
+            }
+        }
+    }
+    return reachable;
+}
+
+/// \brief Refines the given initial partition until all states
+/// in every block are equivalent, and returns the refined block
+/// id of every state. States in block NoState are ignored; they
+/// must not be reachable from the other states.
+/// This is Hopcroft's algorithm: a worklist holds (splitter block,
+/// symbol) pairs, and every block that is split only puts its
+/// smaller half on the worklist. That bounds the total work by
+/// O(k n log n) for n states and k symbols.
+template<typename TChar>
+std::vector<uint32_t> CompiledDFA<TChar>::RefinePartition(std::vector<uint32_t> Blocks) const
+{
+    auto n = this->stateCount;
+    auto k = this->getRowLength();
+
+    // Inverse transitions, grouped by (target, symbol).
+    std::vector<uint32_t> inverseOffsets((std::size_t)n * k + 1, 0);
+    for (uint32_t q = 0; q < n; q++)
+        if (Blocks[q] != NoState)
+            for (uint32_t a = 0; a < k; a++)
+                inverseOffsets[(std::size_t)this->PerformTransition(q, a) * k + a + 1]++;
+    for (std::size_t i = 1; i < inverseOffsets.size(); i++)
+        inverseOffsets[i] += inverseOffsets[i - 1];
+    std::vector<uint32_t> inverseSources(inverseOffsets.back());
+    {
+        std::vector<uint32_t> fill(inverseOffsets.begin(), inverseOffsets.end() - 1);
+        for (uint32_t q = 0; q < n; q++)
+            if (Blocks[q] != NoState)
+                for (uint32_t a = 0; a < k; a++)
+                    inverseSources[fill[(std::size_t)this->PerformTransition(q, a) * k + a]++] = q;
+    }
+
+    // Lay out the states block by block. Each block owns a contiguous
+    // range of 'elements'; states that are marked during a split are
+    // swapped to the front of their block's range.
+    std::vector<uint32_t> elements;
+    std::vector<uint32_t> location(n, NoState);
+    std::vector<uint32_t> blockOf(n, NoState);
+    std::vector<uint32_t> blockStart, blockEnd, markedCount;
+    {
+        std::unordered_map<uint32_t, uint32_t> initialIds;
+        std::vector<std::vector<uint32_t>> members;
+        for (uint32_t q = 0; q < n; q++)
+        {
+            if (Blocks[q] == NoState)
+                continue;
+            auto iter = initialIds.find(Blocks[q]);
+            uint32_t id;
+            if (iter == initialIds.end())
+            {
+                id = (uint32_t)members.size();
+                initialIds[Blocks[q]] = id;
+                members.push_back(std::vector<uint32_t>());
+            }
+            else
+            {
+                id = iter->second;
+            }
+            members[id].push_back(q);
+        }
+        for (uint32_t b = 0; b < (uint32_t)members.size(); b++)
+        {
+            blockStart.push_back((uint32_t)elements.size());
+            for (auto q : members[b])
+            {
+                location[q] = (uint32_t)elements.size();
+                blockOf[q] = b;
+                elements.push_back(q);
+            }
+            blockEnd.push_back((uint32_t)elements.size());
+            markedCount.push_back(0);
+        }
+    }
+
+    // Every block but the largest one is an initial splitter.
+    std::vector<std::pair<uint32_t, uint32_t>> worklist;
+    std::vector<bool> inWorklist(blockStart.size() * k, false);
+    uint32_t largest = 0;
+    for (uint32_t b = 1; b < (uint32_t)blockStart.size(); b++)
+        if (blockEnd[b] - blockStart[b] > blockEnd[largest] - blockStart[largest])
+            largest = b;
+    for (uint32_t b = 0; b < (uint32_t)blockStart.size(); b++)
+        if (b != largest)
+            for (uint32_t a = 0; a < k; a++)
+            {
+                worklist.push_back(std::make_pair(b, a));
+                inWorklist[b * k + a] = true;
+            }
+
+    std::vector<uint32_t> predecessors;
+    std::vector<uint32_t> touched;
+    while (!worklist.empty())
+    {
+        auto splitter = worklist.back();
+        worklist.pop_back();
+        inWorklist[splitter.first * k + splitter.second] = false;
+
+        predecessors.clear();
+        for (auto i = blockStart[splitter.first]; i < blockEnd[splitter.first]; i++)
+        {
+            auto slot = (std::size_t)elements[i] * k + splitter.second;
+            predecessors.insert(predecessors.end(),
+                                inverseSources.begin() + inverseOffsets[slot],
+                                inverseSources.begin() + inverseOffsets[slot + 1]);
+        }
+
+        // Every state has exactly one successor per symbol, so no state
+        // is marked twice.
+        touched.clear();
+        for (auto q : predecessors)
+        {
+            auto b = blockOf[q];
+            if (markedCount[b] == 0)
+                touched.push_back(b);
+            auto target = blockStart[b] + markedCount[b];
+            auto other = elements[target];
+            elements[location[q]] = other;
+            location[other] = location[q];
+            elements[target] = q;
+            location[q] = target;
+            markedCount[b]++;
+        }
+
+        for (auto b : touched)
+        {
+            auto marked = markedCount[b];
+            markedCount[b] = 0;
+            if (marked == blockEnd[b] - blockStart[b])
+                continue;
+
+            // Split the marked states off into a new block.
+            auto newBlock = (uint32_t)blockStart.size();
+            blockStart.push_back(blockStart[b]);
+            blockEnd.push_back(blockStart[b] + marked);
+            markedCount.push_back(0);
+            blockStart[b] += marked;
+            for (auto i = blockStart[newBlock]; i < blockEnd[newBlock]; i++)
+                blockOf[elements[i]] = newBlock;
+            inWorklist.resize(blockStart.size() * k, false);
+
+            auto oldSize = blockEnd[b] - blockStart[b];
+            auto smaller = marked < oldSize ? newBlock : b;
+            for (uint32_t a = 0; a < k; a++)
+            {
+                auto added = inWorklist[b * k + a] ? newBlock : smaller;
+                if (!inWorklist[added * k + a])
+                {
+                    worklist.push_back(std::make_pair(added, a));
+                    inWorklist[added * k + a] = true;
+                }
+            }
+        }
+    }
+
+    // Renumber the blocks in order of their smallest state id.
+    std::vector<uint32_t> renamed(blockStart.size(), NoState);
+    std::vector<uint32_t> results(n, NoState);
+    uint32_t blockCount = 0;
+    for (uint32_t q = 0; q < n; q++)
+    {
+        if (blockOf[q] == NoState)
+            continue;
+        if (renamed[blockOf[q]] == NoState)
+            renamed[blockOf[q]] = blockCount++;
+        results[q] = renamed[blockOf[q]];
+    }
+    return results;
+}
+
+/// \brief Creates a DFA whose states are named by the given
+/// vector, which is indexed by state id. Only states that are
+/// reachable from the start state by the alphabet's symbols are
+/// included, so the dead state only appears if some defined
+/// transition leads to it.
+template<typename TChar>
+template<typename TState>
+DFAutomaton<TState, TChar> CompiledDFA<TChar>::ToDFAutomaton(const std::vector<TState>& States) const
+{
+    auto symbolCount = this->symbolTable.getCount();
+    std::vector<bool> reachable(this->stateCount, false);
+    std::vector<uint32_t> worklist(1, this->startState);
+    reachable[this->startState] = true;
+    std::unordered_map<std::pair<TState, TChar>, TState> transMap;
+    std::vector<TState> accepting;
+    while (!worklist.empty())
+    {
+        auto q = worklist.back();
+        worklist.pop_back();
+        if (this->IsAcceptingState(q))
+            accepting.push_back(States[q]);
+        for (uint32_t a = 0; a < symbolCount; a++)
+        {
+            auto target = this->PerformTransition(q, a);
+            transMap[std::pair<TState, TChar>(States[q], this->symbolTable.GetSymbol(a))] = States[target];
+            if (!reachable[target])
+            {
+                reachable[target] = true;
+                worklist.push_back(target);
+            }
+        }
+    }
+    return DFAutomaton<TState, TChar>(States[this->startState], LinearSet<TState>(accepting),
+                                      TransitionTable<std::pair<TState, TChar>, TState>(transMap));
+}
+
+/// \brief Converts the given string of symbols to a string of
+/// symbol ids.
+template<typename TChar>
+std::vector<uint32_t> CompiledDFA<TChar>::TranslateSymbols(stdx::ArraySlice<TChar> Characters) const
+{
+    return this->symbolTable.Translate(Characters, this->getOtherSymbol());
+}
+
+/// \brief Gets the accepting state bitmap. Bit (i % 64) of word
+/// (i / 64) is set if state i is an accepting state.
+template<typename TChar>
+const std::vector<uint64_t>& CompiledDFA<TChar>::getAcceptingStates() const
+{
+    return this->acceptingStates;
+}
+
+/// \brief Gets the 256-entry table that maps every byte to the
+/// column of the single-byte symbol that consists of it.
+template<typename TChar>
+const uint32_t* CompiledDFA<TChar>::getByteColumns() const
+{
+    return this->byteColumns.data();
+}
+
+/// \brief Gets the id of the "other" symbol, which stands for
+/// every symbol that is not in this automaton's alphabet.
+template<typename TChar>
+uint32_t CompiledDFA<TChar>::getOtherSymbol() const
+{
+    return this->symbolTable.getCount();
+}
+
+/// \brief Gets the number of entries in a single row of the
+/// transition table.
+template<typename TChar>
+uint32_t CompiledDFA<TChar>::getRowLength() const
+{
+    return this->symbolTable.getCount() + 1;
+}
+
+/// \brief Gets this automaton's start state.
+template<typename TChar>
+uint32_t CompiledDFA<TChar>::getStartState() const
+{
+    return this->startState;
+}
+
+/// \brief Gets the number of states in this automaton, including
+/// the dead state.
+template<typename TChar>
+uint32_t CompiledDFA<TChar>::getStateCount() const
+{
+    return this->stateCount;
+}
+
+/// \brief Gets this automaton's alphabet. A symbol's id is its
+/// index in this vector.
+template<typename TChar>
+const std::vector<TChar>& CompiledDFA<TChar>::getSymbols() const
+{
+    return this->symbolTable.getSymbols();
+}
+
+/// \brief Gets the table that assigns this automaton's symbols
+/// their ids.
+template<typename TChar>
+const SymbolTable<TChar>& CompiledDFA<TChar>::getSymbolTable() const
+{
+    return this->symbolTable;
+}
+
+/// \brief Gets the row-major transition table.
+template<typename TChar>
+const std::vector<uint32_t>& CompiledDFA<TChar>::getTransitions() const
+{
+    return this->transitions;
+}
+
+#include "DFAutomaton.h"
\ No newline at end of file
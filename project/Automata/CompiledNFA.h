@@ -0,0 +1,214 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ArraySlice.h"
+#include "CompiledDFA.h"
+#include "IAutomaton.h"
+#include "SparseSet.h"
+#include "SubsetTable.h"
+#include "SymbolTable.h"
+
+namespace Automata
+{
+    template<typename TState, typename TChar>
+    class NFAutomaton;
+
+    template<typename TState, typename TChar>
+    class ENFAutomaton;
+
+    /// \brief Defines a non-deterministic finite automaton, possibly with
+    /// epsilon transitions, whose states and symbols have been
+    /// numbered. Transitions are stored in compressed sparse row form:
+    /// the labeled edges of every state occupy a contiguous range of
+    /// the edge arrays, sorted by symbol and then by target, so the
+    /// successors for a (state, symbol) pair are a contiguous range as
+    /// well. Epsilon edges are stored in separate arrays of the same
+    /// shape. The epsilon graph is condensed into its strongly
+    /// connected components once, and the epsilon-closure of every
+    /// component is precomputed, so that taking a closure never has to
+    /// search the graph. Symbol id getSymbolCount() stands for every
+    /// symbol that is not in the alphabet. Raw byte strings can be
+    /// matched directly: every byte is treated as the single-byte
+    /// symbol that consists of it.
+    template<typename TChar>
+    class CompiledNFA : public virtual IAutomaton<TChar>
+    {
+    public:
+        /// \brief Creates an automaton that consists of a single,
+        /// non-accepting state.
+        CompiledNFA();
+
+        /// \brief Creates a compiled automaton from the given alphabet,
+        /// state count, start state and accepting states. Labeled edges
+        /// are given as (source, symbol, target) triples, and epsilon
+        /// edges as (source, target) pairs. Duplicate edges are
+        /// removed.
+        CompiledNFA(SymbolTable<TChar> Symbols, uint32_t StateCount, uint32_t StartState, std::vector<uint32_t> AcceptingStates, std::vector<uint32_t> Edges, std::vector<uint32_t> EpsilonEdges);
+
+        /// \brief Figures out whether this automaton accepts the given
+        /// string of symbols.
+        bool Accepts(stdx::ArraySlice<TChar> Characters) const override;
+
+        /// \brief Figures out whether this automaton accepts the given
+        /// string of symbol ids.
+        bool Accepts(const uint32_t* Symbols, std::size_t Length) const;
+
+        /// \brief Figures out whether this automaton accepts the given
+        /// string of bytes.
+        bool Accepts(const char* Data, std::size_t Length) const;
+
+        /// \brief Finds out whether the given set of states contains an
+        /// accepting state.
+        bool ContainsAcceptingState(const SparseSet& States) const;
+
+        /// \brief Performs the subset construction on this automaton, and
+        /// returns the resulting integer-numbered DFA. Only subsets
+        /// that are reachable from the start state's closure are
+        /// created; the empty subset is the DFA's dead state.
+        CompiledDFA<TChar> Determinize() const;
+
+        /// \brief Performs the subset construction on this automaton,
+        /// and stores the subset of states that corresponds to each
+        /// DFA state in the given table, indexed by DFA state id.
+        CompiledDFA<TChar> Determinize(SubsetTable& Subsets) const;
+
+        /// \brief Performs the subset construction on the given number of
+        /// worker threads, or on one worker per hardware thread if the
+        /// given number is zero. The subsets are expanded one
+        /// breadth-first level at a time: the workers compute the
+        /// successors of a level's subsets in parallel, and the new
+        /// subsets are then numbered in the same order as Determinize
+        /// numbers them, so the result does not depend on the number of
+        /// workers.
+        CompiledDFA<TChar> Determinize(SubsetTable& Subsets, unsigned ThreadCount) const;
+
+        /// \brief Adds the epsilon-closure of the given set of states to
+        /// that set.
+        void Eclose(SparseSet& States) const;
+
+        /// \brief Gets the id of the given symbol. Symbols that are not in
+        /// this automaton's alphabet are mapped to getSymbolCount().
+        uint32_t GetSymbolId(const TChar& Character) const;
+
+        /// \brief Gets the id of the single-byte symbol that consists of
+        /// the given byte.
+        uint32_t GetByteSymbolId(unsigned char Byte) const;
+
+        /// \brief Finds out if the state with the given id is an accepting
+        /// state.
+        bool IsAcceptingState(uint32_t State) const;
+
+        /// \brief Adds the set of all states reachable by performing a
+        /// single transition with the given symbol from any state in
+        /// the given set to the result set. Epsilon-closures are not
+        /// taken.
+        void PerformAllTransitions(const SparseSet& States, uint32_t Symbol, SparseSet& Result) const;
+
+        /// \brief Performs the extended transition that starts at the given
+        /// state and pursues the given string of symbol ids, taking
+        /// epsilon-closures along the way. The resulting set of states
+        /// is stored in the given set.
+        void PerformExtendedTransition(uint32_t State, const uint32_t* Symbols, std::size_t Length, SparseSet& Result) const;
+
+        /// \brief Creates an equivalent automaton without epsilon edges.
+        /// Every state gets the labeled edges of all states in its
+        /// closure, and it is accepting if its closure contains an
+        /// accepting state. Only the states that are reachable from the
+        /// start state are kept.
+        CompiledNFA<TChar> RemoveEpsilons() const;
+
+        /// \brief Creates an equivalent automaton without epsilon edges,
+        /// and stores the id that every state of the new automaton had
+        /// in this automaton in the given vector.
+        CompiledNFA<TChar> RemoveEpsilons(std::vector<uint32_t>& States) const;
+
+        /// \brief Creates an e-NFA with integer states that is equivalent
+        /// to this automaton.
+        ENFAutomaton<uint32_t, TChar> ToENFAutomaton() const;
+
+        /// \brief Creates an NFA with integer states from this automaton.
+        /// The automaton must not have any epsilon edges.
+        NFAutomaton<uint32_t, TChar> ToNFAutomaton() const;
+
+        /// \brief Converts the given string of symbols to a string of
+        /// symbol ids.
+        std::vector<uint32_t> TranslateSymbols(stdx::ArraySlice<TChar> Characters) const;
+
+        /// \brief Gets the ids of this automaton's accepting states, in
+        /// ascending order.
+        const std::vector<uint32_t>& getAcceptingStates() const;
+
+        /// \brief Gets the symbols of all labeled edges, grouped by source
+        /// state.
+        const std::vector<uint32_t>& getEdgeSymbols() const;
+
+        /// \brief Gets the targets of all labeled edges, grouped by source
+        /// state.
+        const std::vector<uint32_t>& getEdgeTargets() const;
+
+        /// \brief Gets the offsets of every state's labeled edges: the
+        /// edges of state q are in the range [offsets[q], offsets[q + 1]).
+        const std::vector<uint32_t>& getEdgeOffsets() const;
+
+        /// \brief Gets the offsets of every state's epsilon edges.
+        const std::vector<uint32_t>& getEpsilonOffsets() const;
+
+        /// \brief Gets the targets of all epsilon edges, grouped by source
+        /// state.
+        const std::vector<uint32_t>& getEpsilonTargets() const;
+
+        /// \brief Checks if this automaton has any epsilon edges.
+        bool getHasEpsilonEdges() const;
+
+        /// \brief Checks if the epsilon-closures of this automaton's states
+        /// have been precomputed. They are not if the automaton has no
+        /// epsilon edges, or if the closures would be too large.
+        bool getHasPrecomputedClosures() const;
+
+        /// \brief Gets this automaton's start state.
+        uint32_t getStartState() const;
+
+        /// \brief Gets the number of states in this automaton.
+        uint32_t getStateCount() const;
+
+        /// \brief Gets the number of symbols in this automaton's alphabet.
+        uint32_t getSymbolCount() const;
+
+        /// \brief Gets this automaton's alphabet. A symbol's id is its
+        /// index in this vector.
+        const std::vector<TChar>& getSymbols() const;
+
+        /// \brief Gets the table that assigns this automaton's symbols
+        /// their ids.
+        const SymbolTable<TChar>& getSymbolTable() const;
+    private:
+        /// \brief The maximal total size of the precomputed closures.
+        static const std::size_t MaxClosureSize = 1 << 24;
+
+        /// \brief The number of subsets that a worker of the parallel
+        /// subset construction claims at a time.
+        static const uint32_t SubsetsPerChunk = 64;
+
+        /// \brief Condenses the epsilon graph into its strongly connected
+        /// components, and computes the epsilon-closure of every
+        /// component.
+        void PrecomputeClosures();
+
+        SymbolTable<TChar> symbolTable;
+        uint32_t stateCount;
+        uint32_t startState;
+        std::vector<uint32_t> acceptingStates;
+        std::vector<bool> isAccepting;
+        std::vector<uint32_t> edgeOffsets;
+        std::vector<uint32_t> edgeSymbols;
+        std::vector<uint32_t> edgeTargets;
+        std::vector<uint32_t> epsilonOffsets;
+        std::vector<uint32_t> epsilonTargets;
+        std::vector<uint32_t> componentOf;
+        std::vector<uint32_t> closureOffsets;
+        std::vector<uint32_t> closureStates;
+    };
+}
+
+#include "CompiledNFA.hxx"
\ No newline at end of file
@@ -0,0 +1,811 @@
+#include "CompiledNFA.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "ArraySlice.h"
+#include "CompiledDFA.h"
+#include "IAutomaton.h"
+#include "LinearSet.h"
+#include "Optional.h"
+#include "SparseSet.h"
+#include "SubsetTable.h"
+#include "SymbolTable.h"
+#include "TransitionTable.h"
+
+using namespace Automata;
+
+template<typename TChar>
+const std::size_t CompiledNFA<TChar>::MaxClosureSize;
+
+template<typename TChar>
+const uint32_t CompiledNFA<TChar>::SubsetsPerChunk;
+
+/// \brief Creates an automaton that consists of a single,
+/// non-accepting state.
+template<typename TChar>
+CompiledNFA<TChar>::CompiledNFA()
+    : stateCount(1), startState(0), isAccepting(1, false),
+      edgeOffsets(2, 0), epsilonOffsets(2, 0)
+{ }
+
+/// \brief Creates a compiled automaton from the given alphabet,
+/// state count, start state and accepting states. Labeled edges
+/// are given as (source, symbol, target) triples, and epsilon
+/// edges as (source, target) pairs. Duplicate edges are
+/// removed.
+template<typename TChar>
+CompiledNFA<TChar>::CompiledNFA(SymbolTable<TChar> Symbols, uint32_t StateCount, uint32_t StartState, std::vector<uint32_t> AcceptingStates, std::vector<uint32_t> Edges, std::vector<uint32_t> EpsilonEdges)
+    : symbolTable(Symbols), stateCount(StateCount), startState(StartState), isAccepting(StateCount, false)
+{
+    for (auto q : AcceptingStates)
+        this->isAccepting[q] = true;
+    for (uint32_t q = 0; q < StateCount; q++)
+        if (this->isAccepting[q])
+            this->acceptingStates.push_back(q);
+
+    // Bucket the labeled edges by source state, then sort every bucket
+    // by (symbol, target) and drop duplicates.
+    std::vector<uint32_t> starts(StateCount + 1, 0);
+    for (std::size_t i = 0; i < Edges.size(); i += 3)
+        starts[Edges[i] + 1]++;
+    for (uint32_t q = 0; q < StateCount; q++)
+        starts[q + 1] += starts[q];
+    std::vector<uint64_t> keys(Edges.size() / 3);
+    {
+        std::vector<uint32_t> cursor(starts.begin(), starts.end() - 1);
+        for (std::size_t i = 0; i < Edges.size(); i += 3)
+            keys[cursor[Edges[i]]++] = ((uint64_t)Edges[i + 1] << 32) | Edges[i + 2];
+    }
+    this->edgeOffsets.push_back(0);
+    for (uint32_t q = 0; q < StateCount; q++)
+    {
+        std::sort(keys.begin() + starts[q], keys.begin() + starts[q + 1]);
+        for (auto i = starts[q]; i < starts[q + 1]; i++)
+        {
+            if (i > starts[q] && keys[i] == keys[i - 1])
+                continue;
+            this->edgeSymbols.push_back((uint32_t)(keys[i] >> 32));
+            this->edgeTargets.push_back((uint32_t)keys[i]);
+        }
+        this->edgeOffsets.push_back((uint32_t)this->edgeTargets.size());
+    }
+
+    // Epsilon edges get the same treatment.
+    std::vector<uint32_t> epsilonStarts(StateCount + 1, 0);
+    for (std::size_t i = 0; i < EpsilonEdges.size(); i += 2)
+        epsilonStarts[EpsilonEdges[i] + 1]++;
+    for (uint32_t q = 0; q < StateCount; q++)
+        epsilonStarts[q + 1] += epsilonStarts[q];
+    std::vector<uint32_t> targets(EpsilonEdges.size() / 2);
+    {
+        std::vector<uint32_t> cursor(epsilonStarts.begin(), epsilonStarts.end() - 1);
+        for (std::size_t i = 0; i < EpsilonEdges.size(); i += 2)
+            targets[cursor[EpsilonEdges[i]]++] = EpsilonEdges[i + 1];
+    }
+    this->epsilonOffsets.push_back(0);
+    for (uint32_t q = 0; q < StateCount; q++)
+    {
+        std::sort(targets.begin() + epsilonStarts[q], targets.begin() + epsilonStarts[q + 1]);
+        for (auto i = epsilonStarts[q]; i < epsilonStarts[q + 1]; i++)
+        {
+            if (i > epsilonStarts[q] && targets[i] == targets[i - 1])
+                continue;
+            this->epsilonTargets.push_back(targets[i]);
+        }
+        this->epsilonOffsets.push_back((uint32_t)this->epsilonTargets.size());
+    }
+    this->PrecomputeClosures();
+}
+
+/// \brief Figures out whether this automaton accepts the given
+/// string of symbols.
+template<typename TChar>
+bool CompiledNFA<TChar>::Accepts(stdx::ArraySlice<TChar> Characters) const
+{
+    auto symbols = this->TranslateSymbols(Characters);
+    return this->Accepts(symbols.data(), symbols.size());
+}
+
+/// \brief Figures out whether this automaton accepts the given
+/// string of symbol ids.
+template<typename TChar>
+bool CompiledNFA<TChar>::Accepts(const uint32_t* Symbols, std::size_t Length) const
+{
+    SparseSet states(this->stateCount);
+    this->PerformExtendedTransition(this->startState, Symbols, Length, states);
+    return this->ContainsAcceptingState(states);
+}
+
+/// \brief Figures out whether this automaton accepts the given
+/// string of bytes.
+template<typename TChar>
+bool CompiledNFA<TChar>::Accepts(const char* Data, std::size_t Length) const
+{
+    SparseSet states(this->stateCount);
+    SparseSet next(this->stateCount);
+    states.Add(this->startState);
+    this->Eclose(states);
+    for (std::size_t i = 0; i < Length && !states.getIsEmpty(); i++)
+    {
+        next.Clear();
+        this->PerformAllTransitions(states, this->GetByteSymbolId((unsigned char)Data[i]), next);
+        this->Eclose(next);
+        std::swap(states, next);
+    }
+    return this->ContainsAcceptingState(states);
+}
+
+/// \brief Finds out whether the given set of states contains an
+/// accepting state.
+template<typename TChar>
+bool CompiledNFA<TChar>::ContainsAcceptingState(const SparseSet& States) const
+{
+    for (auto q : States.getItems())
+        if (this->isAccepting[q])
+            return true;
+
+    return false;
+}
+
+/// \brief Performs the subset construction on this automaton, and
+/// returns the resulting integer-numbered DFA. Only subsets
+/// that are reachable from the start state's closure are
+/// created; the empty subset is the DFA's dead state.
+template<typename TChar>
+CompiledDFA<TChar> CompiledNFA<TChar>::Determinize() const
+{
+    SubsetTable subsets;
+    return this->Determinize(subsets);
+}
+
+/// \brief Performs the subset construction on this automaton,
+/// and stores the subset of states that corresponds to each
+/// DFA state in the given table, indexed by DFA state id.
+template<typename TChar>
+CompiledDFA<TChar> CompiledNFA<TChar>::Determinize(SubsetTable& Subsets) const
+{
+    auto rowLength = this->getSymbolCount() + 1;
+    bool added;
+    Subsets.Clear();
+    Subsets.Add(nullptr, 0, added);
+    std::vector<uint32_t> transitions(rowLength, CompiledDFA<TChar>::DeadState);
+    std::vector<uint64_t> accepting;
+
+    SparseSet successors(this->stateCount);
+    successors.Add(this->startState);
+    this->Eclose(successors);
+    std::vector<uint32_t> canonical(successors.getItems());
+    std::sort(canonical.begin(), canonical.end());
+    auto startId = Subsets.Add(canonical.data(), canonical.size(), added);
+
+    // Subsets are numbered in the order in which they are discovered,
+    // so processing them in order of their ids makes the subset table
+    // itself the FIFO worklist. Only the symbols that label an edge out
+    // of the current subset are considered; all other symbols lead to
+    // the dead state.
+    std::vector<std::vector<uint32_t>> buckets(this->getSymbolCount());
+    std::vector<uint32_t> touched;
+    std::vector<uint32_t> current;
+    for (uint32_t id = 1; id < Subsets.getCount(); id++)
+    {
+        transitions.resize((std::size_t)(id + 1) * rowLength, CompiledDFA<TChar>::DeadState);
+        current.assign(Subsets.GetItems(id), Subsets.GetItems(id) + Subsets.GetSize(id));
+        for (auto q : current)
+        {
+            if (this->isAccepting[q])
+            {
+                accepting.resize((id >> 6) + 1, 0);
+                accepting[id >> 6] |= (uint64_t)1 << (id & 63);
+            }
+            for (auto i = this->edgeOffsets[q]; i < this->edgeOffsets[q + 1]; i++)
+            {
+                auto symbol = this->edgeSymbols[i];
+                if (buckets[symbol].empty())
+                    touched.push_back(symbol);
+                buckets[symbol].push_back(this->edgeTargets[i]);
+            }
+        }
+        for (auto symbol : touched)
+        {
+            successors.Clear();
+            for (auto q : buckets[symbol])
+                successors.Add(q);
+            buckets[symbol].clear();
+            this->Eclose(successors);
+            canonical.assign(successors.getItems().begin(), successors.getItems().end());
+            std::sort(canonical.begin(), canonical.end());
+            transitions[(std::size_t)id * rowLength + symbol] = Subsets.Add(canonical.data(), canonical.size(), added);
+        }
+        touched.clear();
+    }
+    return CompiledDFA<TChar>(this->symbolTable, Subsets.getCount(), startId, transitions, accepting);
+}
+
+/// \brief Performs the subset construction on the given number of
+/// worker threads, or on one worker per hardware thread if the
+/// given number is zero. The subsets are expanded one
+/// breadth-first level at a time: the workers compute the
+/// successors of a level's subsets in parallel, and the new
+/// subsets are then numbered in the same order as Determinize
+/// numbers them, so the result does not depend on the number of
+/// workers.
+template<typename TChar>
+CompiledDFA<TChar> CompiledNFA<TChar>::Determinize(SubsetTable& Subsets, unsigned ThreadCount) const
+{
+    auto threadCount = ThreadCount == 0 ? std::max(1u, std::thread::hardware_concurrency()) : ThreadCount;
+    if (threadCount == 1)
+        return this->Determinize(Subsets);
+
+    // The successors of a chunk of subsets, in the order in which the
+    // sequential construction would visit them. Successor i is reached
+    // by SuccessorSymbols[i], and has id SuccessorIds[i] if it was
+    // already known when the level started. Only the successors that
+    // were not known are stored, in Items: the n-th of them is a subset
+    // of SuccessorSizes[n] items. Most successors are known, so this
+    // keeps a level's buffers close to the size of its new subsets.
+    struct Chunk
+    {
+        std::vector<uint8_t> Accepting;
+        std::vector<uint32_t> SuccessorCounts;
+        std::vector<uint32_t> SuccessorSymbols;
+        std::vector<uint32_t> SuccessorSizes;
+        std::vector<uint32_t> SuccessorIds;
+        std::vector<uint32_t> Items;
+    };
+    struct Scratch
+    {
+        Scratch(uint32_t StateCount, uint32_t SymbolCount)
+            : Successors(StateCount), Buckets(SymbolCount)
+        { }
+
+        SparseSet Successors;
+        std::vector<std::vector<uint32_t>> Buckets;
+        std::vector<uint32_t> Touched;
+    };
+
+    auto rowLength = this->getSymbolCount() + 1;
+    bool added;
+    Subsets.Clear();
+    Subsets.Add(nullptr, 0, added);
+    std::vector<uint32_t> transitions(rowLength, CompiledDFA<TChar>::DeadState);
+    std::vector<uint64_t> accepting;
+
+    SparseSet successors(this->stateCount);
+    successors.Add(this->startState);
+    this->Eclose(successors);
+    std::vector<uint32_t> canonical(successors.getItems());
+    std::sort(canonical.begin(), canonical.end());
+    auto startId = Subsets.Add(canonical.data(), canonical.size(), added);
+
+    std::vector<Scratch> scratch;
+    for (unsigned w = 0; w < threadCount; w++)
+        scratch.push_back(Scratch(this->stateCount, this->getSymbolCount()));
+    std::vector<Chunk> chunks;
+    uint32_t levelStart = startId;
+    while (levelStart < Subsets.getCount())
+    {
+        auto levelEnd = Subsets.getCount();
+        auto chunkCount = (levelEnd - levelStart + SubsetsPerChunk - 1) / SubsetsPerChunk;
+        chunks.assign(chunkCount, Chunk());
+
+        // Workers claim chunks of the level until none are left, so
+        // a worker that draws cheap subsets simply claims more chunks.
+        // The subset table is only read while the workers run.
+        std::atomic<uint32_t> nextChunk(0);
+        auto work = [&](unsigned Worker)
+        {
+            auto& local = scratch[Worker];
+            std::vector<uint32_t> sorted;
+            for (auto c = nextChunk++; c < chunkCount; c = nextChunk++)
+            {
+                auto& chunk = chunks[c];
+                auto first = levelStart + c * SubsetsPerChunk;
+                auto last = std::min(levelEnd, first + SubsetsPerChunk);
+                for (auto id = first; id < last; id++)
+                {
+                    auto items = Subsets.GetItems(id);
+                    auto size = Subsets.GetSize(id);
+                    bool isAccepting = false;
+                    for (uint32_t i = 0; i < size; i++)
+                    {
+                        auto q = items[i];
+                        isAccepting = isAccepting || this->isAccepting[q];
+                        for (auto j = this->edgeOffsets[q]; j < this->edgeOffsets[q + 1]; j++)
+                        {
+                            auto symbol = this->edgeSymbols[j];
+                            if (local.Buckets[symbol].empty())
+                                local.Touched.push_back(symbol);
+                            local.Buckets[symbol].push_back(this->edgeTargets[j]);
+                        }
+                    }
+                    chunk.Accepting.push_back(isAccepting ? 1 : 0);
+                    chunk.SuccessorCounts.push_back((uint32_t)local.Touched.size());
+                    for (auto symbol : local.Touched)
+                    {
+                        local.Successors.Clear();
+                        for (auto q : local.Buckets[symbol])
+                            local.Successors.Add(q);
+                        local.Buckets[symbol].clear();
+                        this->Eclose(local.Successors);
+                        sorted.assign(local.Successors.getItems().begin(), local.Successors.getItems().end());
+                        std::sort(sorted.begin(), sorted.end());
+                        auto target = Subsets.Find(sorted.data(), sorted.size());
+                        chunk.SuccessorSymbols.push_back(symbol);
+                        chunk.SuccessorIds.push_back(target);
+                        if (target == SubsetTable::NoSubset)
+                        {
+                            chunk.SuccessorSizes.push_back((uint32_t)sorted.size());
+                            chunk.Items.insert(chunk.Items.end(), sorted.begin(), sorted.end());
+                        }
+                    }
+                    local.Touched.clear();
+                }
+            }
+        };
+        auto workers = std::min<uint32_t>(threadCount, chunkCount);
+        std::vector<std::thread> threads;
+        for (unsigned w = 1; w < workers; w++)
+            threads.push_back(std::thread(work, w));
+        work(0);
+        for (auto& thread : threads)
+            thread.join();
+
+        // Number the level's new subsets in order.
+        for (uint32_t c = 0; c < chunkCount; c++)
+        {
+            auto& chunk = chunks[c];
+            auto id = levelStart + c * SubsetsPerChunk;
+            std::size_t successor = 0;
+            std::size_t stored = 0;
+            std::size_t offset = 0;
+            for (std::size_t k = 0; k < chunk.Accepting.size(); k++, id++)
+            {
+                transitions.resize((std::size_t)(id + 1) * rowLength, CompiledDFA<TChar>::DeadState);
+                if (chunk.Accepting[k])
+                {
+                    accepting.resize((id >> 6) + 1, 0);
+                    accepting[id >> 6] |= (uint64_t)1 << (id & 63);
+                }
+                for (uint32_t i = 0; i < chunk.SuccessorCounts[k]; i++, successor++)
+                {
+                    auto target = chunk.SuccessorIds[successor];
+                    if (target == SubsetTable::NoSubset)
+                    {
+                        // Successors that are new to the level may still
+                        // be equal to each other, so Add deduplicates them.
+                        auto size = chunk.SuccessorSizes[stored++];
+                        target = Subsets.Add(chunk.Items.data() + offset, size, added);
+                        offset += size;
+                    }
+                    transitions[(std::size_t)id * rowLength + chunk.SuccessorSymbols[successor]] = target;
+                }
+            }
+        }
+        levelStart = levelEnd;
+    }
+    return CompiledDFA<TChar>(this->symbolTable, Subsets.getCount(), startId, transitions, accepting);
+}
+
+/// \brief Adds the epsilon-closure of the given set of states to
+/// that set.
+template<typename TChar>
+void CompiledNFA<TChar>::Eclose(SparseSet& States) const
+{
+    if (this->getHasPrecomputedClosures())
+    {
+        // Closures are closed under epsilon edges themselves, so only
+        // the states that were in the set to begin with need to be
+        // expanded.
+        auto count = States.getCount();
+        for (uint32_t i = 0; i < count; i++)
+        {
+            auto component = this->componentOf[States.getItems()[i]];
+            for (auto j = this->closureOffsets[component]; j < this->closureOffsets[component + 1]; j++)
+                States.Add(this->closureStates[j]);
+        }
+        return;
+    }
+
+    // The set's item vector doubles as the worklist: every state that
+    // is added is visited exactly once.
+    auto& items = States.getItems();
+    for (std::size_t i = 0; i < items.size(); i++)
+    {
+        auto q = items[i];
+        for (auto j = this->epsilonOffsets[q]; j < this->epsilonOffsets[q + 1]; j++)
+            States.Add(this->epsilonTargets[j]);
+    }
+}
+
+/// \brief Gets the id of the given symbol. Symbols that are not in
+/// this automaton's alphabet are mapped to getSymbolCount().
+template<typename TChar>
+uint32_t CompiledNFA<TChar>::GetSymbolId(const TChar& Character) const
+{
+    auto id = this->symbolTable.GetId(Character);
+    return id == SymbolTable<TChar>::NoSymbol ? this->getSymbolCount() : id;
+}
+
+/// \brief Gets the id of the single-byte symbol that consists of
+/// the given byte.
+template<typename TChar>
+uint32_t CompiledNFA<TChar>::GetByteSymbolId(unsigned char Byte) const
+{
+    auto id = this->symbolTable.GetByteId(Byte);
+    return id == SymbolTable<TChar>::NoSymbol ? this->getSymbolCount() : id;
+}
+
+/// \brief Finds out if the state with the given id is an accepting
+/// state.
+template<typename TChar>
+bool CompiledNFA<TChar>::IsAcceptingState(uint32_t State) const
+{
+    return this->isAccepting[State];
+}
+
+/// \brief Adds the set of all states reachable by performing a
+/// single transition with the given symbol from any state in
+/// the given set to the result set. Epsilon-closures are not
+/// taken.
+template<typename TChar>
+void CompiledNFA<TChar>::PerformAllTransitions(const SparseSet& States, uint32_t Symbol, SparseSet& Result) const
+{
+    auto symbolData = this->edgeSymbols.data();
+    for (auto q : States.getItems())
+    {
+        auto range = std::equal_range(symbolData + this->edgeOffsets[q],
+                                      symbolData + this->edgeOffsets[q + 1], Symbol);
+        for (auto i = range.first - symbolData; i < range.second - symbolData; i++)
+            Result.Add(this->edgeTargets[i]);
+    }
+}
+
+/// \brief Performs the extended transition that starts at the given
+/// state and pursues the given string of symbol ids, taking
+/// epsilon-closures along the way. The resulting set of states
+/// is stored in the given set.
+template<typename TChar>
+void CompiledNFA<TChar>::PerformExtendedTransition(uint32_t State, const uint32_t* Symbols, std::size_t Length, SparseSet& Result) const
+{
+    SparseSet next(this->stateCount);
+    Result.Resize(this->stateCount);
+    Result.Add(State);
+    this->Eclose(Result);
+    for (std::size_t i = 0; i < Length && !Result.getIsEmpty(); i++)
+    {
+        next.Clear();
+        this->PerformAllTransitions(Result, Symbols[i], next);
+        this->Eclose(next);
+        std::swap(Result, next);
+    }
+}
+
+/// \brief Creates an equivalent automaton without epsilon edges.
+/// Every state gets the labeled edges of all states in its
+/// closure, and it is accepting if its closure contains an
+/// accepting state. Only the states that are reachable from the
+/// start state are kept.
+template<typename TChar>
+CompiledNFA<TChar> CompiledNFA<TChar>::RemoveEpsilons() const
+{
+    std::vector<uint32_t> states;
+    return this->RemoveEpsilons(states);
+}
+
+/// \brief Creates an equivalent automaton without epsilon edges,
+/// and stores the id that every state of the new automaton had
+/// in this automaton in the given vector.
+template<typename TChar>
+CompiledNFA<TChar> CompiledNFA<TChar>::RemoveEpsilons(std::vector<uint32_t>& States) const
+{
+    // States are renumbered in the order in which they are reached, so
+    // the start state keeps id zero.
+    std::vector<uint32_t> newIds(this->stateCount, CompiledDFA<TChar>::NoState);
+    States.assign(1, this->startState);
+    newIds[this->startState] = 0;
+    std::vector<uint32_t> accepting;
+    std::vector<uint32_t> edges;
+    SparseSet closure(this->stateCount);
+    for (uint32_t p = 0; p < (uint32_t)States.size(); p++)
+    {
+        closure.Clear();
+        closure.Add(States[p]);
+        this->Eclose(closure);
+        if (this->ContainsAcceptingState(closure))
+            accepting.push_back(p);
+        for (auto q : closure.getItems())
+        {
+            for (auto i = this->edgeOffsets[q]; i < this->edgeOffsets[q + 1]; i++)
+            {
+                auto target = this->edgeTargets[i];
+                if (newIds[target] == CompiledDFA<TChar>::NoState)
+                {
+                    newIds[target] = (uint32_t)States.size();
+                    States.push_back(target);
+                }
+                edges.push_back(p);
+                edges.push_back(this->edgeSymbols[i]);
+                edges.push_back(newIds[target]);
+            }
+        }
+    }
+    return CompiledNFA<TChar>(this->symbolTable, (uint32_t)States.size(), 0, accepting, edges, std::vector<uint32_t>());
+}
+
+/// \brief Creates an e-NFA with integer states that is equivalent
+/// to this automaton.
+template<typename TChar>
+ENFAutomaton<uint32_t, TChar> CompiledNFA<TChar>::ToENFAutomaton() const
+{
+    std::unordered_map<std::pair<uint32_t, Optional<TChar>>, LinearSet<uint32_t>> transitions;
+    for (uint32_t q = 0; q < this->stateCount; q++)
+    {
+        for (auto i = this->edgeOffsets[q]; i < this->edgeOffsets[q + 1]; i++)
+            transitions[std::pair<uint32_t, Optional<TChar>>(q, Optional<TChar>(this->symbolTable.GetSymbol(this->edgeSymbols[i])))].Add(this->edgeTargets[i]);
+        for (auto j = this->epsilonOffsets[q]; j < this->epsilonOffsets[q + 1]; j++)
+            transitions[std::pair<uint32_t, Optional<TChar>>(q, Optional<TChar>())].Add(this->epsilonTargets[j]);
+    }
+    return ENFAutomaton<uint32_t, TChar>(this->startState,
+                                         LinearSet<uint32_t>(this->acceptingStates),
+                                         TransitionTable<std::pair<uint32_t, Optional<TChar>>, LinearSet<uint32_t>>(transitions));
+}
+
+/// \brief Creates an NFA with integer states from this automaton.
+/// The automaton must not have any epsilon edges.
+template<typename TChar>
+NFAutomaton<uint32_t, TChar> CompiledNFA<TChar>::ToNFAutomaton() const
+{
+    std::unordered_map<std::pair<uint32_t, TChar>, LinearSet<uint32_t>> transitions;
+    for (uint32_t q = 0; q < this->stateCount; q++)
+        for (auto i = this->edgeOffsets[q]; i < this->edgeOffsets[q + 1]; i++)
+            transitions[std::pair<uint32_t, TChar>(q, this->symbolTable.GetSymbol(this->edgeSymbols[i]))].Add(this->edgeTargets[i]);
+    return NFAutomaton<uint32_t, TChar>(this->startState,
+                                        LinearSet<uint32_t>(this->acceptingStates),
+                                        TransitionTable<std::pair<uint32_t, TChar>, LinearSet<uint32_t>>(transitions));
+}
+
+/// \brief Converts the given string of symbols to a string of
+/// symbol ids.
+template<typename TChar>
+std::vector<uint32_t> CompiledNFA<TChar>::TranslateSymbols(stdx::ArraySlice<TChar> Characters) const
+{
+    return this->symbolTable.Translate(Characters, this->getSymbolCount());
+}
+
+/// \brief Gets the ids of this automaton's accepting states, in
+/// ascending order.
+template<typename TChar>
+const std::vector<uint32_t>& CompiledNFA<TChar>::getAcceptingStates() const
+{
+    return this->acceptingStates;
+}
+
+/// \brief Gets the symbols of all labeled edges, grouped by source
+/// state.
+template<typename TChar>
+const std::vector<uint32_t>& CompiledNFA<TChar>::getEdgeSymbols() const
+{
+    return this->edgeSymbols;
+}
+
+/// \brief Gets the targets of all labeled edges, grouped by source
+/// state.
+template<typename TChar>
+const std::vector<uint32_t>& CompiledNFA<TChar>::getEdgeTargets() const
+{
+    return this->edgeTargets;
+}
+
+/// \brief Gets the offsets of every state's labeled edges: the
+/// edges of state q are in the range [offsets[q], offsets[q + 1]).
+template<typename TChar>
+const std::vector<uint32_t>& CompiledNFA<TChar>::getEdgeOffsets() const
+{
+    return this->edgeOffsets;
+}
+
+/// \brief Gets the offsets of every state's epsilon edges.
+template<typename TChar>
+const std::vector<uint32_t>& CompiledNFA<TChar>::getEpsilonOffsets() const
+{
+    return this->epsilonOffsets;
+}
+
+/// \brief Gets the targets of all epsilon edges, grouped by source
+/// state.
+template<typename TChar>
+const std::vector<uint32_t>& CompiledNFA<TChar>::getEpsilonTargets() const
+{
+    return this->epsilonTargets;
+}
+
+/// \brief Checks if this automaton has any epsilon edges.
+template<typename TChar>
+bool CompiledNFA<TChar>::getHasEpsilonEdges() const
+{
+    return !this->epsilonTargets.empty();
+}
+
+/// \brief Checks if the epsilon-closures of this automaton's states
+/// have been precomputed. They are not if the automaton has no
+/// epsilon edges, or if the closures would be too large.
+template<typename TChar>
+bool CompiledNFA<TChar>::getHasPrecomputedClosures() const
+{
+    return !this->closureOffsets.empty();
+}
+
+/// \brief Gets this automaton's start state.
+template<typename TChar>
+uint32_t CompiledNFA<TChar>::getStartState() const
+{
+    return this->startState;
+}
+
+/// \brief Gets the number of states in this automaton.
+template<typename TChar>
+uint32_t CompiledNFA<TChar>::getStateCount() const
+{
+    return this->stateCount;
+}
+
+/// \brief Gets the number of symbols in this automaton's alphabet.
+template<typename TChar>
+uint32_t CompiledNFA<TChar>::getSymbolCount() const
+{
+    return this->symbolTable.getCount();
+}
+
+/// \brief Gets this automaton's alphabet. A symbol's id is its
+/// index in this vector.
+template<typename TChar>
+const std::vector<TChar>& CompiledNFA<TChar>::getSymbols() const
+{
+    return this->symbolTable.getSymbols();
+}
+
+/// \brief Gets the table that assigns this automaton's symbols
+/// their ids.
+template<typename TChar>
+const SymbolTable<TChar>& CompiledNFA<TChar>::getSymbolTable() const
+{
+    return this->symbolTable;
+}
+
+/// \brief Condenses the epsilon graph into its strongly connected
+/// components, and computes the epsilon-closure of every
+/// component.
+template<typename TChar>
+void CompiledNFA<TChar>::PrecomputeClosures()
+{
+    if (!this->getHasEpsilonEdges())
+        return;
+
+    // Tarjan's algorithm, with an explicit call stack. Components are
+    // completed in reverse topological order: every component that is
+    // reachable from a component gets a smaller id.
+    const uint32_t unvisited = 0xFFFFFFFF;
+    std::vector<uint32_t> index(this->stateCount, unvisited);
+    std::vector<uint32_t> lowLink(this->stateCount);
+    std::vector<bool> onStack(this->stateCount, false);
+    std::vector<uint32_t> stack;
+    std::vector<std::pair<uint32_t, uint32_t>> calls;
+    this->componentOf.assign(this->stateCount, 0);
+    uint32_t nextIndex = 0;
+    uint32_t componentCount = 0;
+    for (uint32_t root = 0; root < this->stateCount; root++)
+    {
+        if (index[root] != unvisited)
+            continue;
+
+        index[root] = lowLink[root] = nextIndex++;
+        stack.push_back(root);
+        onStack[root] = true;
+        calls.push_back(std::make_pair(root, this->epsilonOffsets[root]));
+        while (!calls.empty())
+        {
+            auto v = calls.back().first;
+            auto edge = calls.back().second;
+            if (edge < this->epsilonOffsets[v + 1])
+            {
+                calls.back().second++;
+                auto w = this->epsilonTargets[edge];
+                if (index[w] == unvisited)
+                {
+                    index[w] = lowLink[w] = nextIndex++;
+                    stack.push_back(w);
+                    onStack[w] = true;
+                    calls.push_back(std::make_pair(w, this->epsilonOffsets[w]));
+                }
+                else if (onStack[w])
+                {
+                    lowLink[v] = std::min(lowLink[v], index[w]);
+                }
+                continue;
+            }
+
+            calls.pop_back();
+            if (lowLink[v] == index[v])
+            {
+                uint32_t w;
+                do
+                {
+                    w = stack.back();
+                    stack.pop_back();
+                    onStack[w] = false;
+                    this->componentOf[w] = componentCount;
+                } while (w != v);
+                componentCount++;
+            }
+            if (!calls.empty())
+            {
+                auto u = calls.back().first;
+                lowLink[u] = std::min(lowLink[u], lowLink[v]);
+            }
+        }
+    }
+
+    // Group the states by component.
+    std::vector<uint32_t> memberOffsets(componentCount + 1, 0);
+    for (uint32_t q = 0; q < this->stateCount; q++)
+        memberOffsets[this->componentOf[q] + 1]++;
+    for (uint32_t c = 0; c < componentCount; c++)
+        memberOffsets[c + 1] += memberOffsets[c];
+    std::vector<uint32_t> members(this->stateCount);
+    {
+        std::vector<uint32_t> cursor(memberOffsets.begin(), memberOffsets.end() - 1);
+        for (uint32_t q = 0; q < this->stateCount; q++)
+            members[cursor[this->componentOf[q]]++] = q;
+    }
+
+    // A component's closure consists of its own members and the
+    // closures of the components it has edges to, which have already
+    // been computed.
+    std::vector<uint32_t> stamp(this->stateCount, unvisited);
+    this->closureOffsets.assign(1, 0);
+    for (uint32_t c = 0; c < componentCount; c++)
+    {
+        for (auto i = memberOffsets[c]; i < memberOffsets[c + 1]; i++)
+        {
+            auto q = members[i];
+            if (stamp[q] != c)
+            {
+                stamp[q] = c;
+                this->closureStates.push_back(q);
+            }
+            for (auto j = this->epsilonOffsets[q]; j < this->epsilonOffsets[q + 1]; j++)
+            {
+                auto d = this->componentOf[this->epsilonTargets[j]];
+                if (d == c)
+                    continue;
+                for (auto k = this->closureOffsets[d]; k < this->closureOffsets[d + 1]; k++)
+                {
+                    auto r = this->closureStates[k];
+                    if (stamp[r] != c)
+                    {
+                        stamp[r] = c;
+                        this->closureStates.push_back(r);
+                    }
+                }
+            }
+        }
+        if (this->closureStates.size() > MaxClosureSize)
+        {
+            // Fall back to searching the epsilon graph.
+            this->componentOf.clear();
+            this->closureOffsets.clear();
+            this->closureStates.clear();
+            return;
+        }
+        this->closureOffsets.push_back((uint32_t)this->closureStates.size());
+    }
+}
+
+#include "NFAutomaton.h"
+#include "ENFAutomaton.h"
\ No newline at end of file
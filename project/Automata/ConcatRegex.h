@@ -1,9 +1,10 @@
 #pragma once
+#include <cstddef>
 #include <memory>
 #include <string>
 #include "ENFAutomaton.h"
 #include "IRegex.h"
-#include "RegexState.h"
+#include "ThompsonBuilder.h"
 
 namespace Automata
 {
@@ -14,26 +15,30 @@ namespace Automata
         /// \brief Creates a new concat regex for the given operands.
         ConcatRegex(std::shared_ptr<IRegex> Left, std::shared_ptr<IRegex> Right);
 
-        /// \brief Creates an epsilon-nfa for this concatenation regex.
-        /// The construction is as follows:   * Automata are
-        /// constructed for the left and right operands of this concat
-        /// operation.   * These automata are "merged":     * The start
-        /// state of the resulting automaton is the start state
-        /// of the left operand's automaton.
-        /// * The accepting states of the resulting automaton is
-        /// the set of accepting       states of the right operand's
-        /// automaton.   * For each accepting state in the left
-        /// automaton, an epsilon-transition     is added to the
-        /// resulting automaton that starts at said accepting     state
-        /// and points to the right automaton's intial state.
-        ENFAutomaton<std::shared_ptr<RegexState>, std::string> ToENFAutomaton() const override;
+        /// \brief Appends this concatenation regex's e-NFA to the given
+        /// builder. The construction is as follows:
+        /// * Fragments are appended for the left and right operands.
+        /// * An epsilon-transition is added from the left fragment's
+        ///   accepting state to the right fragment's start state.
+        /// * The resulting fragment starts at the left fragment's start
+        ///   state, and ends at the right fragment's accepting state.
+        RegexFragment AppendENFAutomaton(ThompsonBuilder& Builder) const override;
 
         /// \brief Gets this regex's string representation.
         std::string ToString() const override;
 
+        /// \brief Gets this regex's hash code, which depends on its
+        /// structure only, and is computed when the regex is created.
+        std::size_t getHashCode() const override;
+
+        /// \brief Gets this regex's kind.
+        RegexKind getKind() const override;
+
         /// \brief The concat regex's left operand.
         std::shared_ptr<IRegex> Left;
         /// \brief The concat regex's right operand.
         std::shared_ptr<IRegex> Right;
+    private:
+        std::size_t hashCode;
     };
 }
\ No newline at end of file
@@ -0,0 +1,298 @@
+#include "DFAImage.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "CompiledDFA.h"
+#include "MappedFile.h"
+#include "SymbolTable.h"
+
+using namespace Automata;
+
+namespace
+{
+    /// \brief The magic bytes that every image starts with.
+    const char ImageMagic[8] = { 'A', 'U', 'T', 'O', 'D', 'F', 'A', '\0' };
+
+    /// \brief A value that is stored in every image's header, and which
+    /// reads differently if the image was written on a machine with
+    /// a different byte order.
+    const uint32_t ImageByteOrder = 0x01020304;
+
+    /// \brief Defines the layout of an image's header. Section offsets
+    /// are relative to the start of the image.
+    struct ImageHeader
+    {
+        char Magic[8];
+        uint32_t ByteOrder;
+        uint32_t Version;
+        uint32_t StateCount;
+        uint32_t StartState;
+        uint32_t SymbolCount;
+        uint32_t Reserved;
+        uint64_t SymbolOffsets;
+        uint64_t SymbolData;
+        uint64_t ByteColumns;
+        uint64_t Transitions;
+        uint64_t AcceptingStates;
+        uint64_t Size;
+    };
+
+    /// \brief Rounds the given offset up to the next section boundary.
+    uint64_t AlignSection(uint64_t Offset)
+    {
+        return (Offset + 7) & ~(uint64_t)7;
+    }
+
+    /// \brief Checks if the section of the given size at the given
+    /// offset is aligned, and lies within an image of the given size.
+    bool IsSectionInBounds(uint64_t Offset, uint64_t Length, uint64_t Size)
+    {
+        return Offset % 8 == 0 && Offset <= Size && Length <= Size - Offset;
+    }
+
+    /// \brief Writes the given number of zero bytes to the given stream.
+    void WritePadding(std::ostream& Output, uint64_t Length)
+    {
+        static const char zeros[8] = { };
+        Output.write(zeros, (std::streamsize)Length);
+    }
+}
+
+const uint32_t DFAImage::FormatVersion;
+
+/// \brief Maps the image at the given path into memory. Throws an
+/// exception if the file is not a valid image.
+DFAImage::DFAImage(const std::string& Path)
+    : file(std::make_shared<MappedFile>(Path))
+{
+    this->Load(this->file->getData(), this->file->getSize());
+}
+
+/// \brief Creates an image that refers to the given buffer, which
+/// must be aligned to an eight-byte boundary and outlive the
+/// image. Throws an exception if the buffer is not a valid
+/// image.
+DFAImage::DFAImage(const char* Data, std::size_t Size)
+{
+    this->Load(Data, Size);
+}
+
+/// \brief Checks if the file at the given path starts with the
+/// magic bytes of an image.
+bool DFAImage::IsImage(const std::string& Path)
+{
+    std::ifstream input(Path, std::ios::binary);
+    char magic[sizeof(ImageMagic)];
+    return input.read(magic, sizeof(magic)) && std::memcmp(magic, ImageMagic, sizeof(magic)) == 0;
+}
+
+/// \brief Writes the given automaton to the given stream as an
+/// image. The stream must be opened in binary mode.
+void DFAImage::Write(const CompiledDFA<std::string>& Automaton, std::ostream& Output)
+{
+    auto& symbols = Automaton.getSymbols();
+    std::vector<uint64_t> symbolOffsets(symbols.size() + 1, 0);
+    for (std::size_t i = 0; i < symbols.size(); i++)
+        symbolOffsets[i + 1] = symbolOffsets[i] + symbols[i].size();
+    auto& transitions = Automaton.getTransitions();
+    auto& accepting = Automaton.getAcceptingStates();
+
+    ImageHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.Magic, ImageMagic, sizeof(ImageMagic));
+    header.ByteOrder = ImageByteOrder;
+    header.Version = FormatVersion;
+    header.StateCount = Automaton.getStateCount();
+    header.StartState = Automaton.getStartState();
+    header.SymbolCount = (uint32_t)symbols.size();
+    header.SymbolOffsets = AlignSection(sizeof(ImageHeader));
+    header.SymbolData = header.SymbolOffsets + symbolOffsets.size() * sizeof(uint64_t);
+    header.ByteColumns = AlignSection(header.SymbolData + symbolOffsets.back());
+    header.Transitions = header.ByteColumns + 256 * sizeof(uint32_t);
+    header.AcceptingStates = AlignSection(header.Transitions + transitions.size() * sizeof(uint32_t));
+    header.Size = header.AcceptingStates + accepting.size() * sizeof(uint64_t);
+
+    Output.write((const char*)&header, sizeof(header));
+    WritePadding(Output, header.SymbolOffsets - sizeof(header));
+    Output.write((const char*)symbolOffsets.data(), (std::streamsize)(symbolOffsets.size() * sizeof(uint64_t)));
+    for (auto& symbol : symbols)
+        Output.write(symbol.data(), (std::streamsize)symbol.size());
+    WritePadding(Output, header.ByteColumns - header.SymbolData - symbolOffsets.back());
+    Output.write((const char*)Automaton.getByteColumns(), 256 * sizeof(uint32_t));
+    Output.write((const char*)transitions.data(), (std::streamsize)(transitions.size() * sizeof(uint32_t)));
+    WritePadding(Output, header.AcceptingStates - header.Transitions - transitions.size() * sizeof(uint32_t));
+    Output.write((const char*)accepting.data(), (std::streamsize)(accepting.size() * sizeof(uint64_t)));
+}
+
+/// \brief Checks the image's header and section bounds, and sets
+/// up pointers to its sections. Throws an exception if the
+/// image is not valid.
+void DFAImage::Load(const char* Data, std::size_t Size)
+{
+    if (Size < sizeof(ImageHeader) || std::memcmp(Data, ImageMagic, sizeof(ImageMagic)) != 0)
+        throw std::invalid_argument("Not a compiled automaton image.");
+    if ((uintptr_t)Data % 8 != 0)
+        throw std::invalid_argument("Compiled automaton images must be aligned to an eight-byte boundary.");
+
+    auto& header = *(const ImageHeader*)Data;
+    if (header.ByteOrder != ImageByteOrder)
+        throw std::invalid_argument("Compiled automaton image was written with a different byte order.");
+    if (header.Version != FormatVersion)
+        throw std::invalid_argument("Unsupported compiled automaton image version " + std::to_string(header.Version) + ".");
+
+    uint64_t rowLength = (uint64_t)header.SymbolCount + 1;
+    uint64_t acceptingWords = ((uint64_t)header.StateCount + 63) / 64;
+    if (header.Size != Size || header.StateCount == 0 || header.StartState >= header.StateCount
+        || (uint64_t)header.StateCount * rowLength > Size / sizeof(uint32_t)
+        || !IsSectionInBounds(header.SymbolOffsets, rowLength * sizeof(uint64_t), Size)
+        || !IsSectionInBounds(header.ByteColumns, 256 * sizeof(uint32_t), Size)
+        || !IsSectionInBounds(header.Transitions, (uint64_t)header.StateCount * rowLength * sizeof(uint32_t), Size)
+        || !IsSectionInBounds(header.AcceptingStates, acceptingWords * sizeof(uint64_t), Size)
+        || header.SymbolData > Size)
+        throw std::invalid_argument("Compiled automaton image is malformed.");
+
+    this->stateCount = header.StateCount;
+    this->startState = header.StartState;
+    this->symbolCount = header.SymbolCount;
+    this->symbolOffsets = (const uint64_t*)(Data + header.SymbolOffsets);
+    this->symbolData = Data + header.SymbolData;
+    this->byteColumns = (const uint32_t*)(Data + header.ByteColumns);
+    this->transitions = (const uint32_t*)(Data + header.Transitions);
+    this->acceptingStates = (const uint64_t*)(Data + header.AcceptingStates);
+
+    if (this->symbolOffsets[this->symbolCount] > Size - header.SymbolData)
+        throw std::invalid_argument("Compiled automaton image is malformed.");
+    for (uint32_t i = 0; i < this->symbolCount; i++)
+        if (this->symbolOffsets[i] > this->symbolOffsets[i + 1])
+            throw std::invalid_argument("Compiled automaton image is malformed.");
+    for (int b = 0; b < 256; b++)
+        if (this->byteColumns[b] >= rowLength)
+            throw std::invalid_argument("Compiled automaton image is malformed.");
+}
+
+/// \brief Checks if this automaton accepts the given string of
+/// bytes.
+bool DFAImage::Accepts(const char* Data, std::size_t Length) const
+{
+    return this->IsAcceptingState(this->PerformExtendedTransition(this->startState, Data, Length));
+}
+
+/// \brief Gets the symbol with the given id.
+std::string DFAImage::GetSymbol(uint32_t Id) const
+{
+    return std::string(this->symbolData + this->symbolOffsets[Id],
+                       this->symbolData + this->symbolOffsets[Id + 1]);
+}
+
+/// \brief Finds out if the state with the given id is an
+/// accepting state.
+bool DFAImage::IsAcceptingState(uint32_t State) const
+{
+    return ((this->acceptingStates[State / 64] >> (State % 64)) & 1) != 0;
+}
+
+/// \brief Applies the automaton's extended transition function to
+/// the given state and string of bytes.
+uint32_t DFAImage::PerformExtendedTransition(uint32_t State, const char* Data, std::size_t Length) const
+{
+    auto rowLength = this->getRowLength();
+    auto table = this->transitions;
+    auto columns = this->byteColumns;
+    for (std::size_t i = 0; i < Length; i++)
+        State = table[(std::size_t)State * rowLength + columns[(unsigned char)Data[i]]];
+    return State;
+}
+
+/// \brief Applies the automaton's transition function to the given
+/// state and symbol id.
+uint32_t DFAImage::PerformTransition(uint32_t State, uint32_t Symbol) const
+{
+    return this->transitions[(std::size_t)State * this->getRowLength() + Symbol];
+}
+
+/// \brief Copies this image into a compiled automaton. Throws an
+/// exception if a transition leads to a state that does not
+/// exist.
+CompiledDFA<std::string> DFAImage::ToCompiledDFA() const
+{
+    std::vector<std::string> symbols;
+    symbols.reserve(this->symbolCount);
+    for (uint32_t i = 0; i < this->symbolCount; i++)
+        symbols.push_back(this->GetSymbol(i));
+    auto size = (std::size_t)this->stateCount * this->getRowLength();
+    std::vector<uint32_t> transitions(size);
+    for (std::size_t i = 0; i < size; i++)
+    {
+        if (this->transitions[i] >= this->stateCount)
+            throw std::invalid_argument("Compiled automaton image is malformed.");
+        transitions[i] = this->transitions[i];
+    }
+    std::vector<uint64_t> accepting(this->acceptingStates,
+                                    this->acceptingStates + (this->stateCount + 63) / 64);
+    return CompiledDFA<std::string>(SymbolTable<std::string>(symbols), this->stateCount, this->startState,
+                                    transitions, accepting);
+}
+
+/// \brief Checks that every transition leads to a state that
+/// exists, in one pass over the transition table. Throws an
+/// exception if one does not.
+void DFAImage::Validate() const
+{
+    auto size = (std::size_t)this->stateCount * this->getRowLength();
+    for (std::size_t i = 0; i < size; i++)
+        if (this->transitions[i] >= this->stateCount)
+            throw std::invalid_argument("Compiled automaton image is malformed.");
+}
+
+/// \brief Gets the accepting state bitmap. Bit (i % 64) of word
+/// (i / 64) is set if state i is an accepting state.
+const uint64_t* DFAImage::getAcceptingStates() const
+{
+    return this->acceptingStates;
+}
+
+/// \brief Gets the 256-entry table that maps every byte to the
+/// column of the single-byte symbol that consists of it.
+const uint32_t* DFAImage::getByteColumns() const
+{
+    return this->byteColumns;
+}
+
+/// \brief Gets the number of entries in a single row of the
+/// transition table.
+uint32_t DFAImage::getRowLength() const
+{
+    return this->symbolCount + 1;
+}
+
+/// \brief Gets this automaton's start state.
+uint32_t DFAImage::getStartState() const
+{
+    return this->startState;
+}
+
+/// \brief Gets the number of states in this automaton, including
+/// the dead state.
+uint32_t DFAImage::getStateCount() const
+{
+    return this->stateCount;
+}
+
+/// \brief Gets the number of symbols in this automaton's alphabet.
+uint32_t DFAImage::getSymbolCount() const
+{
+    return this->symbolCount;
+}
+
+/// \brief Gets the row-major transition table.
+const uint32_t* DFAImage::getTransitions() const
+{
+    return this->transitions;
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include "CompiledDFA.h"
+#include "MappedFile.h"
+
+namespace Automata
+{
+    /// \brief Defines a compiled DFA that is stored as a binary image,
+    /// which can be matched against without being parsed or copied.
+    /// An image consists of a fixed-size header, the symbol table, a
+    /// 256-entry byte-to-column table, the dense row-major transition
+    /// table and the accepting state bitmap, in that order. Every
+    /// section starts at an offset that is a multiple of eight bytes,
+    /// so the tables can be used in place once the image is mapped
+    /// into memory. Images are stored in the byte order of the machine
+    /// that wrote them; an image with a different byte order is
+    /// rejected rather than converted.
+    /// Only the image's structure is validated when it is loaded, so
+    /// that a trusted image can be matched without reading every page
+    /// of its transition table up front. The table's entries are
+    /// checked while ToCompiledDFA copies them; an image that is
+    /// matched in place must be checked with Validate first, unless it
+    /// comes from a trusted source.
+    class DFAImage
+    {
+    public:
+        /// \brief The version of the image format that this class reads
+        /// and writes.
+        static const uint32_t FormatVersion = 1;
+
+        /// \brief Maps the image at the given path into memory. Throws an
+        /// exception if the file is not a valid image.
+        DFAImage(const std::string& Path);
+
+        /// \brief Creates an image that refers to the given buffer, which
+        /// must be aligned to an eight-byte boundary and outlive the
+        /// image. Throws an exception if the buffer is not a valid
+        /// image.
+        DFAImage(const char* Data, std::size_t Size);
+
+        /// \brief Checks if the file at the given path starts with the
+        /// magic bytes of an image.
+        static bool IsImage(const std::string& Path);
+
+        /// \brief Writes the given automaton to the given stream as an
+        /// image. The stream must be opened in binary mode.
+        static void Write(const CompiledDFA<std::string>& Automaton, std::ostream& Output);
+
+        /// \brief Checks if this automaton accepts the given string of
+        /// bytes.
+        bool Accepts(const char* Data, std::size_t Length) const;
+
+        /// \brief Gets the symbol with the given id.
+        std::string GetSymbol(uint32_t Id) const;
+
+        /// \brief Finds out if the state with the given id is an
+        /// accepting state.
+        bool IsAcceptingState(uint32_t State) const;
+
+        /// \brief Applies the automaton's extended transition function to
+        /// the given state and string of bytes.
+        uint32_t PerformExtendedTransition(uint32_t State, const char* Data, std::size_t Length) const;
+
+        /// \brief Applies the automaton's transition function to the given
+        /// state and symbol id.
+        uint32_t PerformTransition(uint32_t State, uint32_t Symbol) const;
+
+        /// \brief Copies this image into a compiled automaton. Throws an
+        /// exception if a transition leads to a state that does not
+        /// exist.
+        CompiledDFA<std::string> ToCompiledDFA() const;
+
+        /// \brief Checks that every transition leads to a state that
+        /// exists, in one pass over the transition table. Throws an
+        /// exception if one does not.
+        void Validate() const;
+
+        /// \brief Gets the accepting state bitmap. Bit (i % 64) of word
+        /// (i / 64) is set if state i is an accepting state.
+        const uint64_t* getAcceptingStates() const;
+
+        /// \brief Gets the 256-entry table that maps every byte to the
+        /// column of the single-byte symbol that consists of it.
+        const uint32_t* getByteColumns() const;
+
+        /// \brief Gets the number of entries in a single row of the
+        /// transition table.
+        uint32_t getRowLength() const;
+
+        /// \brief Gets this automaton's start state.
+        uint32_t getStartState() const;
+
+        /// \brief Gets the number of states in this automaton, including
+        /// the dead state.
+        uint32_t getStateCount() const;
+
+        /// \brief Gets the number of symbols in this automaton's alphabet.
+        uint32_t getSymbolCount() const;
+
+        /// \brief Gets the row-major transition table.
+        const uint32_t* getTransitions() const;
+    private:
+        /// \brief Checks the image's header and section bounds, and sets
+        /// up pointers to its sections. Throws an exception if the
+        /// image is not valid.
+        void Load(const char* Data, std::size_t Size);
+
+        std::shared_ptr<const MappedFile> file;
+        uint32_t stateCount;
+        uint32_t startState;
+        uint32_t symbolCount;
+        const uint64_t* symbolOffsets;
+        const char* symbolData;
+        const uint32_t* byteColumns;
+        const uint32_t* transitions;
+        const uint64_t* acceptingStates;
+    };
+}
\ No newline at end of file
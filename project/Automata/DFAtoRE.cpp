@@ -1,43 +1,48 @@
 #include "DFAtoRE.h"
 
-std::shared_ptr<IRegex> concatRE(std::shared_ptr<IRegex> left, std::shared_ptr<IRegex> right){
-	if (left->ToString() == "\\e"){
+// All regexes are built by the same factory, so they are hash-consed:
+// structurally identical regexes are the same object, and comparing
+// them never has to look at their operands.
+
+std::shared_ptr<IRegex> concatRE(RegexFactory& factory, std::shared_ptr<IRegex> left, std::shared_ptr<IRegex> right){
+	if (left->getKind() == EpsilonKind){
 		return right;
 	}
-	else if (right->ToString() == "\\e"){
+	else if (right->getKind() == EpsilonKind){
 		return left;
 	}
-	else if (left->ToString() == "\\p" || right->ToString() == "\\p"){
-		return std::make_shared<PhiRegex>();
+	else if (left->getKind() == PhiKind || right->getKind() == PhiKind){
+		return factory.CreatePhi();
 	}
 
-	return std::make_shared<ConcatRegex>(left, right);
+	return factory.CreateConcat(left, right);
 }
 
-std::shared_ptr<IRegex> unifyRE(std::shared_ptr<IRegex> left, std::shared_ptr<IRegex> right){
-	if (left->ToString() == "\\p"){
+std::shared_ptr<IRegex> unifyRE(RegexFactory& factory, std::shared_ptr<IRegex> left, std::shared_ptr<IRegex> right){
+	if (left->getKind() == PhiKind){
 		return right;
 	}
-	else if (right->ToString() == "\\p"){
+	else if (right->getKind() == PhiKind){
 		return left;
 	}
-	else if (right->ToString() == left->ToString()){
+	else if (right == left){
 		return left;
 	}
 
-	return std::make_shared<UnionRegex>(left, right);
+	return factory.CreateUnion(left, right);
 }
 
-std::shared_ptr<IRegex> closeRE(std::shared_ptr<IRegex> in){
-	if (in->ToString() == "\\e" || in->ToString() == "\\p"){
-		return std::make_shared<EpsilonRegex>();
+std::shared_ptr<IRegex> closeRE(RegexFactory& factory, std::shared_ptr<IRegex> in){
+	if (in->getKind() == EpsilonKind || in->getKind() == PhiKind){
+		return factory.CreateEpsilon();
 	}
-	return std::make_shared<ClosureRegex>(in);
+	return factory.CreateClosure(in);
 }
 
 std::shared_ptr<IRegex> DFAtoRE(DFAutomaton<std::string, std::string>& DFA){
 
-	REAutomaton REA(DFA);
+	RegexFactory factory;
+	REAutomaton REA(DFA, factory);
 
 	auto pointer = REA.toRE();
 
@@ -47,7 +52,8 @@ std::shared_ptr<IRegex> DFAtoRE(DFAutomaton<std::string, std::string>& DFA){
 
 std::shared_ptr<IRegex> NFAtoRE(NFAutomaton<std::string, std::string>& NFA){
 
-	REAutomaton REA(NFA);
+	RegexFactory factory;
+	REAutomaton REA(NFA, factory);
 
 	auto pointer = REA.toRE();
 
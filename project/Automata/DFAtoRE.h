@@ -4,11 +4,13 @@
 #include <vector>
 #include <unordered_map>
 #include <algorithm>
+#include <cstdint>
+#include <map>
+#include <set>
 
 #include "DFAutomaton.h"
 #include "NFAutomaton.h"
 
-#include "RegexState.h"
 #include "IRegex.h"
 #include "PhiRegex.h"
 #include "LiteralRegex.h"
@@ -17,162 +19,174 @@
 #include "ConcatRegex.h"
 #include "ClosureRegex.h"
 #include "HashExtensions.h"
+#include "RegexFactory.h"
 
 typedef std::string State;
 typedef std::string Char;
 
-std::shared_ptr<IRegex> concatRE(std::shared_ptr<IRegex> left, std::shared_ptr<IRegex> right);
-std::shared_ptr<IRegex> unifyRE(std::shared_ptr<IRegex> left, std::shared_ptr<IRegex> right);
-std::shared_ptr<IRegex> closeRE(std::shared_ptr<IRegex> in);
+std::shared_ptr<IRegex> concatRE(RegexFactory& factory, std::shared_ptr<IRegex> left, std::shared_ptr<IRegex> right);
+std::shared_ptr<IRegex> unifyRE(RegexFactory& factory, std::shared_ptr<IRegex> left, std::shared_ptr<IRegex> right);
+std::shared_ptr<IRegex> closeRE(RegexFactory& factory, std::shared_ptr<IRegex> in);
 std::shared_ptr<IRegex> DFAtoRE(DFAutomaton<std::string, std::string>& DFA);
 std::shared_ptr<IRegex> NFAtoRE(NFAutomaton<std::string, std::string>& NFA);
 
+// Converts automata to regexes by state elimination. The automaton is
+// first turned into a generalized NFA with a fresh start state, which
+// has an epsilon-edge to the original start state, and a fresh final
+// state, to which every accepting state has an epsilon-edge. States
+// are numbered, and edges are stored in a sparse matrix: a sorted row
+// of outgoing edges and a set of incoming edges per state. All
+// original states are then eliminated in a single pass, cheapest
+// first, so the interior work is shared by all accepting states, and
+// the regex on the edge from the fresh start state to the fresh final
+// state is the result.
 class REAutomaton
 {
 private:
-	std::vector<State> states;
-	State startState;
-	std::vector<State> acceptStates;
+	RegexFactory* factory;
+	std::unordered_map<State, uint32_t> stateIds;
+	std::vector<std::map<uint32_t, std::shared_ptr<IRegex>>> outgoing;
+	std::vector<std::set<uint32_t>> incoming;
+	uint32_t startState;
+	uint32_t finalState;
+
+	uint32_t getStateId(const State& state){	// Numbers states in order of appearance
+		auto iter = stateIds.find(state);
+		if (iter != stateIds.end()) return iter->second;
+		uint32_t id = (uint32_t)outgoing.size();
+		stateIds[state] = id;
+		outgoing.emplace_back();
+		incoming.emplace_back();
+		return id;
+	}
 
-	std::unordered_map<State, std::unordered_map<State, std::shared_ptr<IRegex>>> transitionMap;
+	void initialize(const State& start, const std::vector<State>& acceptStates){
+		uint32_t originalStart = getStateId(start);
+		for (const State& state : acceptStates) getStateId(state);
 
-public:
-	REAutomaton(DFAutomaton<std::string, std::string>& DFA){	// Create an REAutomaton that mirrors an existing DFA
+		// The fresh start and final states come after all original states
+		uint32_t originalCount = (uint32_t)outgoing.size();
+		outgoing.resize(originalCount + 2);
+		incoming.resize(originalCount + 2);
+		startState = originalCount;
+		finalState = originalCount + 1;
 
-		for (State from : DFA.GetStates().getItems()){
-			for (State to : DFA.GetStates().getItems()){
-				transitionMap[from][to] = std::make_shared<PhiRegex>();
-			}
+		this->addTransition(startState, originalStart, factory->CreateEpsilon());
+		for (const State& state : acceptStates){
+			this->addTransition(stateIds[state], finalState, factory->CreateEpsilon());
 		}
+	}
 
-		for (State state : DFA.GetStates().getItems()){
-			states.push_back(state);
-			for (Char trans : DFA.GetAlphabet().getItems()){
-				if (DFA.PerformTransition(state, trans) != ""){
-					this->addTransition(state, DFA.PerformTransition(state, trans), std::make_shared<LiteralRegex>(trans));
-				}
+	uint64_t eliminationCost(uint32_t s){	// Number of edges that eliminating s creates
+		uint64_t in = incoming[s].size() - incoming[s].count(s);
+		uint64_t out = outgoing[s].size() - outgoing[s].count(s);
+		return in * out;
+	}
+
+	void eliminate(uint32_t s){
+
+		// For every q -> s -> p, add q -> p labeled QS*P, where S is the self-loop of s
+
+		auto loop = outgoing[s].find(s);
+		std::shared_ptr<IRegex> S = closeRE(*factory, loop == outgoing[s].end() ? factory->CreatePhi() : loop->second);
+
+		for (uint32_t q : incoming[s]){
+			if (q == s) continue;
+			std::shared_ptr<IRegex> QS = concatRE(*factory, outgoing[q][s], S);
+			for (auto& edge : outgoing[s]){
+				if (edge.first == s) continue;
+				this->addTransition(q, edge.first, concatRE(*factory, QS, edge.second));
 			}
 		}
 
-		startState = DFA.getStartState();
+		// Remove every trace of state s
 
-		for (State state : DFA.getAcceptingStates().getItems()){
-			acceptStates.push_back(state);
+		for (uint32_t q : incoming[s]){
+			if (q != s) outgoing[q].erase(s);
 		}
+		for (auto& edge : outgoing[s]){
+			if (edge.first != s) incoming[edge.first].erase(s);
+		}
+		outgoing[s].clear();
+		incoming[s].clear();
 	}
 
-	REAutomaton(NFAutomaton<std::string, std::string>& NFA){	// Create an REAutomaton that mirrors an existing NFA
+public:
+	REAutomaton(DFAutomaton<std::string, std::string>& DFA, RegexFactory& Factory){	// Create an REAutomaton that mirrors an existing DFA
+		this->factory = &Factory;
 
-		for (State from : NFA.GetStates().getItems()){
-			for (State to : NFA.GetStates().getItems()){
-				transitionMap[from][to] = std::make_shared<PhiRegex>();
-			}
+		auto states = DFA.GetStates().getItems();
+		auto alphabet = DFA.GetAlphabet().getItems();
+		for (State state : states){
+			if (state != "") getStateId(state);
 		}
-
-		for (State state : NFA.GetStates().getItems()){
-			states.push_back(state);
-			for (Char trans : NFA.GetAlphabet().getItems()){
-				if (!(NFA.PerformTransition(state, trans).getIsEmpty())){
-					for (auto toState : NFA.PerformTransition(state, trans).getItems())
-						this->addTransition(state, toState, std::make_shared<LiteralRegex>(trans));
+		for (State state : states){
+			if (state == "") continue;
+			for (Char trans : alphabet){
+				State target = DFA.PerformTransition(state, trans);
+				if (target != ""){
+					this->addTransition(getStateId(state), getStateId(target), factory->CreateLiteral(trans));
 				}
 			}
 		}
 
-		startState = NFA.getStartState();
-
-		for (State state : NFA.getAcceptingStates().getItems()){
-			acceptStates.push_back(state);
-		}
+		initialize(DFA.getStartState(), DFA.getAcceptingStates().getItems());
 	}
 
-	REAutomaton(REAutomaton* originalREA, State acceptState){	// Create a duplicate REAutomaton that only has a single accept state
-		this->states = originalREA->states;
-		this->startState = originalREA->startState;
-		this->transitionMap = originalREA->transitionMap;
+	REAutomaton(NFAutomaton<std::string, std::string>& NFA, RegexFactory& Factory){	// Create an REAutomaton that mirrors an existing NFA
+		this->factory = &Factory;
+
+		auto states = NFA.GetStates().getItems();
+		auto alphabet = NFA.GetAlphabet().getItems();
+		for (State state : states){
+			getStateId(state);
+		}
+		for (State state : states){
+			for (Char trans : alphabet){
+				for (auto toState : NFA.PerformTransition(state, trans).getItems()){
+					this->addTransition(getStateId(state), getStateId(toState), factory->CreateLiteral(trans));
+				}
+			}
+		}
 
-		this->acceptStates.push_back(acceptState);
+		initialize(NFA.getStartState(), NFA.getAcceptingStates().getItems());
 	}
 
-	void addTransition(State from, State to, std::shared_ptr<IRegex> RE){
-		this->transitionMap[from][to] = unifyRE(transitionMap[from][to], RE);
+	void addTransition(uint32_t from, uint32_t to, std::shared_ptr<IRegex> RE){
+		auto iter = outgoing[from].find(to);
+		if (iter == outgoing[from].end()){
+			outgoing[from][to] = RE;
+			incoming[to].insert(from);
+		}
+		else {
+			iter->second = unifyRE(*factory, iter->second, RE);
+		}
 	}
 
 	std::shared_ptr<IRegex> toRE(){
 
-		std::shared_ptr<IRegex> finalRegex = std::make_shared<PhiRegex>();
-
-		for (State acceptState : acceptStates){		// In a sub-REAutomaton with only one accept state
-			REAutomaton REA(this, acceptState);
-
-			// Reduce the REA to 2 states
-
-			while (REA.states.size() > 2 || (REA.states.size() == 2 && REA.startState == REA.acceptStates[0])){
-
-				// Find a removable state s 			(s = neither start nor accept)
-				State s;
-				for (State state : REA.states){
-					if (state != REA.startState && state != REA.acceptStates[0]) s = state;
-				}
-
-				// Find S : delta(s, S) == s 			(s -> s)
-
-				std::shared_ptr<IRegex> S = REA.transitionMap[s][s];
-
-				for (State q : REA.states){
-					if (q != s){
-
-						// Find Q : delta(q, Q) = s			(q -> s)
-
-						std::shared_ptr<IRegex> Q = REA.transitionMap[q][s];
-
-						for (State p : REA.states){
-							if (p != s){
-
-								// Find P : delta(s, P) = p		(s -> p)
-
-								std::shared_ptr<IRegex> P = REA.transitionMap[s][p];
-
-								// Find R : delta(q, R) = p		(q -> p)
-
-								std::shared_ptr<IRegex> R = REA.transitionMap[q][p];
-
-								// New P = (R + QS*P)
-
-								std::shared_ptr<IRegex> newP = unifyRE(R, concatRE(concatRE(Q, closeRE(S)), P));
-
-								REA.transitionMap[q][p] = newP;
-							}
-						}
-					}
-				}
-
-				// Remove every trace of State s
-
-				REA.states.erase(std::find(REA.states.begin(), REA.states.end(), s));	// Remove s
-				REA.transitionMap.erase(s);												// Remove every transition from s
-				for (State state : REA.states){
-					REA.transitionMap[state].erase(s);									// Remove every transition to s
+		// Eliminate the original states, cheapest first
+
+		std::vector<bool> eliminated(startState, false);
+		for (uint32_t step = 0; step < startState; step++){
+			uint32_t best = startState;
+			uint64_t bestCost = 0;
+			for (uint32_t s = 0; s < startState; s++){
+				if (eliminated[s]) continue;
+				uint64_t cost = eliminationCost(s);
+				if (best == startState || cost < bestCost){
+					best = s;
+					bestCost = cost;
 				}
 			}
-			// Interpret the reduced REA:
-
-			std::shared_ptr<IRegex> R = REA.transitionMap[REA.startState][REA.startState];				// start 	-> 	start	
-			std::shared_ptr<IRegex> S = REA.transitionMap[REA.startState][REA.acceptStates[0]]; 		// start 	-> 	end		
-			std::shared_ptr<IRegex> T = REA.transitionMap[REA.acceptStates[0]][REA.startState];			// end 		-> 	start	
-			std::shared_ptr<IRegex> U = REA.transitionMap[REA.acceptStates[0]][REA.acceptStates[0]]; 	// end 		-> 	end		
-
-			std::shared_ptr<IRegex> thisRegex = std::make_shared<PhiRegex>();
-
-			if (REA.transitionMap.size() > 1){
-				thisRegex = concatRE(closeRE(unifyRE(R, concatRE(concatRE(S, closeRE(U)), T))), concatRE(S, closeRE(U)));
-			}
-			else {
-				thisRegex = closeRE(R);
-			}
-			finalRegex = unifyRE(finalRegex, thisRegex);
+			eliminate(best);
+			eliminated[best] = true;
 		}
 
-		return finalRegex;
+		// Only the fresh start and final states remain
+
+		auto iter = outgoing[startState].find(finalState);
+		if (iter == outgoing[startState].end()) return factory->CreatePhi();
+		return iter->second;
 	}
 };
\ No newline at end of file
@@ -1,10 +1,15 @@
 #pragma once
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 #include "ArraySlice.h"
+#include "CompiledDFA.h"
 #include "IAutomaton.h"
 #include "IFunction.h"
 #include "LinearSet.h"
+#include "SymbolTable.h"
 #include "TransitionTable.h"
 
 namespace Automata
@@ -23,6 +28,24 @@ namespace Automata
         /// symbols.
         bool Accepts(stdx::ArraySlice<TChar> Characters) const override;
 
+        /// \brief Compiles this automaton to a dense transition table, in
+        /// a single pass over its transition function. The start state
+        /// is assigned id one; transitions that are not defined lead
+        /// to the dead state.
+        CompiledDFA<TChar> Compile() const;
+
+        /// \brief Compiles this automaton to a dense transition table, and
+        /// stores the original state that corresponds to each state id
+        /// in the given vector. The dead state is mapped to a
+        /// default-constructed state.
+        CompiledDFA<TChar> Compile(std::vector<TState>& States) const;
+
+        /// \brief Compiles this automaton, numbering its symbols with the
+        /// given symbol table, which is extended with any symbols it
+        /// does not contain yet. The original state that corresponds to
+        /// each state id is stored in the given vector.
+        CompiledDFA<TChar> Compile(const SymbolTable<TChar>& Symbols, std::vector<TState>& States) const;
+
         /// \brief Checks if this automaton is equivalent to the given other
         /// automaton.
         bool EquivalentTo(DFAutomaton<TState, TChar> other) const;
@@ -40,16 +63,24 @@ namespace Automata
         LinearSet<TState> GetStates() const;
 
         /// \brief Gets this automaton's transition function.
-        TransitionTable<std::pair<TState, TChar>, TState> getTransitionFunction() const;
+        const TransitionTable<std::pair<TState, TChar>, TState>& getTransitionFunction() const;
 
         /// \brief Finds out if the given state is an accepting state.
         bool IsAcceptingState(TState State) const;
 
+        /// \brief Applies Hopcroft's partition refinement algorithm to
+        /// this automaton, and returns the resulting sets of equivalent
+        /// states. Unlike the table-filling algorithm, this runs in
+        /// O(k n log n) time for n states and k symbols.
+        std::vector<LinearSet<TState>> HopcroftPartition() const;
+
         /// \brief Optimizes this automaton. First, all reachable states are
-        /// detected. Then, the TFA is applied to these reachable
-        /// states, and all equivalent states are merged.
+        /// detected. Then, Hopcroft's algorithm is applied to these
+        /// reachable states, and all equivalent states are merged.
         /// A new automaton is constructed based on these merged
-        /// states, and then returned.
+        /// states, and then returned. Every merged state is named after
+        /// its whole block of equivalent states, including unreachable
+        /// ones, as HopcroftPartition reports it.
         DFAutomaton<LinearSet<TState>, TChar> Optimize() const;
 
         /// \brief Applies the automaton's extended transition function to
@@ -84,8 +115,23 @@ namespace Automata
 
         /// \brief Performs the table-filling algorithm on this automaton,
         /// and returns the resulting partition of equivalent states.
+        /// This takes more than O(n^4) time; HopcroftPartition computes
+        /// the same partition far more quickly.
         std::unordered_map<TState, LinearSet<TState>> TFAPartition() const;
     private:
+        /// \brief Holds an automaton's compiled form, which is created
+        /// exactly once, even if several threads ask for it at the same
+        /// time.
+        struct CompiledForm
+        {
+            std::once_flag Compiled;
+            CompiledDFA<TChar> Automaton;
+        };
+
+        /// \brief Gets this automaton's compiled form, which is created on
+        /// first use and shared by all copies of this automaton.
+        const CompiledDFA<TChar>& GetCompiledAutomaton() const;
+
         /// \brief Sets this automaton's set of accepting states.
         void setAcceptingStates(LinearSet<TState> value);
 
@@ -98,6 +144,7 @@ namespace Automata
         LinearSet<TState> AcceptingStates_value;
         TState StartState_value;
         TransitionTable<std::pair<TState, TChar>, TState> TransitionFunction_value;
+        std::shared_ptr<CompiledForm> Compiled_value;
     };
 }
 
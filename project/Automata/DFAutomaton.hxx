@@ -1,12 +1,18 @@
 #include "DFAutomaton.h"
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 #include "ArraySlice.h"
+#include "CompiledDFA.h"
 #include "IAutomaton.h"
 #include "IdFunction.h"
 #include "IFunction.h"
 #include "LinearSet.h"
+#include "SymbolTable.h"
 #include "TagFunction.h"
 #include "TransitionTable.h"
 
@@ -21,6 +27,7 @@ DFAutomaton<TState, TChar>::DFAutomaton(TState StartState, LinearSet<TState> Acc
     this->setStartState(StartState);
     this->setAcceptingStates(AcceptingStates);
     this->setTransitionFunction(TransitionFunction);
+    this->Compiled_value = std::make_shared<CompiledForm>();
 }
 
 /// \brief Checks if this automaton accepts the given string of
@@ -28,8 +35,78 @@ DFAutomaton<TState, TChar>::DFAutomaton(TState StartState, LinearSet<TState> Acc
 template<typename TState, typename TChar>
 bool DFAutomaton<TState, TChar>::Accepts(stdx::ArraySlice<TChar> Characters) const
 {
-    return this->IsAcceptingState(this->PerformExtendedTransition(this->getStartState(), 
-                                                                  Characters));
+    return this->GetCompiledAutomaton().Accepts(Characters);
+}
+
+/// \brief Compiles this automaton to a dense transition table, in
+/// a single pass over its transition function. The start state
+/// is assigned id one; transitions that are not defined lead
+/// to the dead state.
+template<typename TState, typename TChar>
+CompiledDFA<TChar> DFAutomaton<TState, TChar>::Compile() const
+{
+    std::vector<TState> states;
+    return this->Compile(states);
+}
+
+/// \brief Compiles this automaton to a dense transition table, and
+/// stores the original state that corresponds to each state id
+/// in the given vector. The dead state is mapped to a
+/// default-constructed state.
+template<typename TState, typename TChar>
+CompiledDFA<TChar> DFAutomaton<TState, TChar>::Compile(std::vector<TState>& States) const
+{
+    return this->Compile(SymbolTable<TChar>(), States);
+}
+
+/// \brief Compiles this automaton, numbering its symbols with the
+/// given symbol table, which is extended with any symbols it
+/// does not contain yet. The original state that corresponds to
+/// each state id is stored in the given vector.
+template<typename TState, typename TChar>
+CompiledDFA<TChar> DFAutomaton<TState, TChar>::Compile(const SymbolTable<TChar>& Symbols, std::vector<TState>& States) const
+{
+    std::unordered_map<TState, uint32_t> stateIds;
+    auto symbols = Symbols;
+    States.clear();
+    States.push_back(TState());
+    auto getStateId = [&](const TState& State) -> uint32_t
+    {
+        auto iter = stateIds.find(State);
+        if (iter != stateIds.end())
+            return iter->second;
+        auto id = (uint32_t)States.size();
+        stateIds[State] = id;
+        States.push_back(State);
+        return id;
+    };
+    auto startId = getStateId(this->getStartState());
+    // Number states and symbols as we go, and remember the numbered
+    // edges, because the table's dimensions are only known at the end.
+    std::vector<uint32_t> edges;
+    auto& transMap = this->getTransitionFunction().getMap();
+    edges.reserve(transMap.size() * 3);
+    for (auto& item : transMap)
+    {
+        auto symbol = symbols.Intern(item.first.second);
+        edges.push_back(getStateId(item.first.first));
+        edges.push_back(symbol);
+        edges.push_back(getStateId(item.second));
+    }
+    auto accepting = this->getAcceptingStates();
+    std::vector<uint32_t> acceptingIds;
+    for (auto& q : accepting.getItems())
+        acceptingIds.push_back(getStateId(q));
+
+    auto stateCount = (uint32_t)States.size();
+    auto rowLength = symbols.getCount() + 1;
+    std::vector<uint32_t> table((std::size_t)stateCount * rowLength, CompiledDFA<TChar>::DeadState);
+    for (std::size_t i = 0; i < edges.size(); i += 3)
+        table[(std::size_t)edges[i] * rowLength + edges[i + 1]] = edges[i + 2];
+    std::vector<uint64_t> acceptBits((stateCount + 63) / 64, 0);
+    for (auto q : acceptingIds)
+        acceptBits[q >> 6] |= (uint64_t)1 << (q & 63);
+    return CompiledDFA<TChar>(symbols, stateCount, startId, table, acceptBits);
 }
 
 /// \brief Checks if this automaton is equivalent to the given other
@@ -51,9 +128,18 @@ bool DFAutomaton<TState, TChar>::EquivalentTo(DFAutomaton<TState, TChar> other)
     DFAutomaton<std::pair<TState, bool>, TChar> mergedAutomaton(taggedThis.getStartState(), 
                                                                 mergedAcceptingStates, 
                                                                 mergedTable);
-    auto partition = mergedAutomaton.TFAPartition();
-    return partition[taggedThis.getStartState()] == 
-           partition[taggedOther.getStartState()];
+    std::vector<std::pair<TState, bool>> states;
+    auto compiled = mergedAutomaton.Compile(states);
+    auto partition = compiled.HopcroftPartition();
+    uint32_t thisStart = compiled.getStartState();
+    // If the other start state has no transitions and does not accept,
+    // then it has not been numbered; it is then equivalent to the
+    // dead state.
+    uint32_t otherStart = CompiledDFA<TChar>::DeadState;
+    for (uint32_t q = 1; q < (uint32_t)states.size(); q++)
+        if (states[q] == taggedOther.getStartState())
+            otherStart = q;
+    return partition[thisStart] == partition[otherStart];
 }
 
 /// \brief Gets this automaton's alphabet, as a set of characters.
@@ -61,7 +147,7 @@ template<typename TState, typename TChar>
 LinearSet<TChar> DFAutomaton<TState, TChar>::GetAlphabet() const
 {
     LinearSet<TChar> results;
-    auto transfunc = this->getTransitionFunction();
+    auto& transfunc = this->getTransitionFunction();
     for (auto& item : transfunc.getMap())
         results.Add(item.first.second);
     return results;
@@ -72,7 +158,7 @@ template<typename TState, typename TChar>
 LinearSet<TState> DFAutomaton<TState, TChar>::GetStates() const
 {
     LinearSet<TState> results;
-    auto transfunc = this->getTransitionFunction();
+    auto& transfunc = this->getTransitionFunction();
     for (auto& item : transfunc.getMap())
     {
         results.Add(item.first.first);
@@ -89,42 +175,82 @@ bool DFAutomaton<TState, TChar>::IsAcceptingState(TState State) const
     return acceptStates.Contains(State);
 }
 
+/// \brief Applies Hopcroft's partition refinement algorithm to
+/// this automaton, and returns the resulting sets of equivalent
+/// states. Unlike the table-filling algorithm, this runs in
+/// O(k n log n) time for n states and k symbols.
+template<typename TState, typename TChar>
+std::vector<LinearSet<TState>> DFAutomaton<TState, TChar>::HopcroftPartition() const
+{
+    std::vector<TState> states;
+    auto compiled = this->Compile(states);
+    auto partition = compiled.HopcroftPartition();
+    // The dead state is not a state of this automaton, so it is left
+    // out of its block.
+    std::vector<std::vector<TState>> blocks(compiled.getStateCount());
+    for (uint32_t q = 1; q < compiled.getStateCount(); q++)
+        blocks[partition[q]].push_back(states[q]);
+    std::vector<LinearSet<TState>> results;
+    for (auto& block : blocks)
+        if (!block.empty())
+            results.push_back(LinearSet<TState>(block));
+    return results;
+}
+
 /// \brief Optimizes this automaton. First, all reachable states are
-/// detected. Then, the TFA is applied to these reachable
-/// states, and all equivalent states are merged.
+/// detected. Then, Hopcroft's algorithm is applied to these
+/// reachable states, and all equivalent states are merged.
 /// A new automaton is constructed based on these merged
-/// states, and then returned.
+/// states, and then returned. Every merged state is named after
+/// its whole block of equivalent states, including unreachable
+/// ones, as HopcroftPartition reports it.
 template<typename TState, typename TChar>
 DFAutomaton<LinearSet<TState>, TChar> DFAutomaton<TState, TChar>::Optimize() const
 {
-    TState sourceState;
-    auto reachable = this->ReachableStates();
-    TransitionTable<std::pair<TState, TChar>, TState> filteredTable;
-    auto oldTable = this->getTransitionFunction();
-    for (auto& item : oldTable.getMap())
-    {
-        sourceState = item.first.first;
-        if (reachable.Contains(sourceState))
-            filteredTable.Add(item.first, item.second);
+    std::vector<TState> states;
+    auto compiled = this->Compile(states);
+    std::vector<uint32_t> stateMap;
+    auto minimal = compiled.Minimize(stateMap);
 
-    }
-    auto partition = this->TFAPartition();
+    // Equivalence does not depend on reachability, so the reachable
+    // members of a block of the full partition all share a state of
+    // the minimal automaton. Blocks without reachable members of this
+    // automaton are left out, like the dead state.
+    auto partition = compiled.HopcroftPartition();
+    std::vector<uint32_t> blockStates(compiled.getStateCount(), CompiledDFA<TChar>::NoState);
+    for (uint32_t q = 1; q < compiled.getStateCount(); q++)
+        if (stateMap[q] != CompiledDFA<TChar>::NoState)
+            blockStates[partition[q]] = stateMap[q];
+    std::vector<std::vector<TState>> members(minimal.getStateCount());
+    for (uint32_t q = 1; q < compiled.getStateCount(); q++)
+        if (blockStates[partition[q]] != CompiledDFA<TChar>::NoState)
+            members[blockStates[partition[q]]].push_back(states[q]);
+    std::vector<LinearSet<TState>> newStates;
+    for (auto& block : members)
+        newStates.push_back(LinearSet<TState>(block));
+
+    // Transitions into the dead state's block are left out, unless
+    // that block also contains states of this automaton.
+    auto& symbols = minimal.getSymbols();
     TransitionTable<std::pair<LinearSet<TState>, TChar>, LinearSet<TState>> optimalTable;
-    for (auto& item0 : filteredTable.getMap())
+    std::vector<LinearSet<TState>> final;
+    for (uint32_t q = 0; q < minimal.getStateCount(); q++)
     {
-        sourceState = item0.first.first;
-        auto symbol = item0.first.second;
-        auto targetState = item0.second;
-        std::pair<LinearSet<TState>, TChar> newPair(partition[sourceState], 
-                                                    symbol);
-        optimalTable.Add(newPair, partition[targetState]);
+        if (members[q].empty())
+            continue;
+        for (uint32_t a = 0; a < (uint32_t)symbols.size(); a++)
+        {
+            auto target = minimal.PerformTransition(q, a);
+            if (!members[target].empty())
+                optimalTable.Add(std::pair<LinearSet<TState>, TChar>(newStates[q], symbols[a]), 
+                                 newStates[target]);
+        }
+        if (minimal.IsAcceptingState(q))
+            final.push_back(newStates[q]);
     }
-    LinearSet<LinearSet<TState>> final;
-    auto accStates = this->getAcceptingStates();
-    for (auto& q : accStates.getItems())
-        final.Add(partition[q]);
-    return DFAutomaton<LinearSet<TState>, TChar>(partition[this->getStartState()], 
-                                                 final, optimalTable);
+    return DFAutomaton<LinearSet<TState>, TChar>(newStates[minimal.getStartState()], 
+                                                 LinearSet<LinearSet<TState>>(final), 
+                                                 optimalTable);
 }
 
 /// \brief Applies the automaton's extended transition function to
@@ -143,8 +269,7 @@ TState DFAutomaton<TState, TChar>::PerformExtendedTransition(TState State, stdx:
 template<typename TState, typename TChar>
 TState DFAutomaton<TState, TChar>::PerformTransition(TState State, TChar Character) const
 {
-    auto transFun = this->getTransitionFunction();
-    return transFun.Apply(std::pair<TState, TChar>(State, Character));
+    return this->getTransitionFunction().Apply(std::pair<TState, TChar>(State, Character));
 }
 
 /// \brief Gets the set of all reachable states in this automaton.
@@ -230,6 +355,19 @@ LinearSet<TState> DFAutomaton<TState, TChar>::getAcceptingStates() const
     return this->AcceptingStates_value;
 }
 
+/// \brief Gets this automaton's compiled form, which is created on
+/// first use and shared by all copies of this automaton.
+template<typename TState, typename TChar>
+const CompiledDFA<TChar>& DFAutomaton<TState, TChar>::GetCompiledAutomaton() const
+{
+    auto& compiled = *this->Compiled_value;
+    std::call_once(compiled.Compiled, [&]()
+    {
+        compiled.Automaton = this->Compile();
+    });
+    return compiled.Automaton;
+}
+
 /// \brief Sets this automaton's set of accepting states.
 template<typename TState, typename TChar>
 void DFAutomaton<TState, TChar>::setAcceptingStates(LinearSet<TState> value)
@@ -253,7 +391,7 @@ void DFAutomaton<TState, TChar>::setStartState(TState value)
 
 /// \brief Gets this automaton's transition function.
 template<typename TState, typename TChar>
-TransitionTable<std::pair<TState, TChar>, TState> DFAutomaton<TState, TChar>::getTransitionFunction() const
+const TransitionTable<std::pair<TState, TChar>, TState>& DFAutomaton<TState, TChar>::getTransitionFunction() const
 {
     return this->TransitionFunction_value;
 }
@@ -0,0 +1,252 @@
+#include "DerivativeCompiler.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ClosureRegex.h"
+#include "CompiledDFA.h"
+#include "ConcatRegex.h"
+#include "IRegex.h"
+#include "LiteralRegex.h"
+#include "SymbolTable.h"
+#include "UnionRegex.h"
+
+using namespace Automata;
+
+const uint32_t DerivativeCompiler::Phi;
+const uint32_t DerivativeCompiler::Epsilon;
+
+/// \brief Creates a derivative compiler.
+DerivativeCompiler::DerivativeCompiler()
+{
+    this->Intern(PhiTerm, 0, 0, false);
+    this->Intern(EpsilonTerm, 0, 0, true);
+}
+
+/// \brief Compiles the given regex, which must consist of
+/// literal, concat, union, closure, epsilon and phi regexes,
+/// to a DFA. State zero is the dead state, which is the phi
+/// term. The DFA's alphabet consists of all symbols this
+/// compiler has seen.
+CompiledDFA<std::string> DerivativeCompiler::Compile(const IRegex* Regex)
+{
+    auto start = this->Convert(Regex);
+    auto symbolCount = this->symbols.getCount();
+
+    // States are numbered in the order in which their terms are
+    // discovered, so the rows of the transition table can be
+    // appended as the states are processed.
+    std::unordered_map<uint32_t, uint32_t> stateIds;
+    std::vector<uint32_t> stateTerms;
+    auto getState = [&](uint32_t Id) -> uint32_t
+    {
+        auto iter = stateIds.find(Id);
+        if (iter != stateIds.end())
+            return iter->second;
+        auto state = (uint32_t)stateTerms.size();
+        stateIds[Id] = state;
+        stateTerms.push_back(Id);
+        return state;
+    };
+    getState(Phi);
+    auto startState = getState(start);
+
+    std::vector<uint32_t> transitions;
+    std::vector<uint64_t> accepting;
+    for (uint32_t state = 0; state < stateTerms.size(); state++)
+    {
+        auto id = stateTerms[state];
+        if (this->terms[id].Nullable)
+        {
+            accepting.resize(state / 64 + 1, 0);
+            accepting[state / 64] |= (uint64_t)1 << (state % 64);
+        }
+        for (uint32_t symbol = 0; symbol < symbolCount; symbol++)
+            transitions.push_back(getState(this->Derive(id, symbol)));
+        transitions.push_back(CompiledDFA<std::string>::DeadState);
+    }
+
+    return CompiledDFA<std::string>(this->symbols, (uint32_t)stateTerms.size(), startState, transitions, accepting);
+}
+
+/// \brief Gets the number of terms that have been created.
+uint32_t DerivativeCompiler::getTermCount() const
+{
+    return (uint32_t)this->terms.size();
+}
+
+/// \brief Hashes the kind and operands of a term.
+std::size_t DerivativeCompiler::TermHash::operator()(const Term& Value) const
+{
+    uint64_t hash = Value.Kind;
+    hash = hash * 0x9E3779B97F4A7C15ULL + Value.Left;
+    hash = hash * 0x9E3779B97F4A7C15ULL + Value.Right;
+    hash ^= hash >> 29;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 32;
+    return (std::size_t)hash;
+}
+
+/// \brief Compares the kind and operands of two terms.
+bool DerivativeCompiler::TermEquals::operator()(const Term& Left, const Term& Right) const
+{
+    return Left.Kind == Right.Kind && Left.Left == Right.Left && Left.Right == Right.Right;
+}
+
+/// \brief Finds or creates the term with the given kind and
+/// operands.
+uint32_t DerivativeCompiler::Intern(TermKind Kind, uint32_t Left, uint32_t Right, bool Nullable)
+{
+    Term term;
+    term.Kind = Kind;
+    term.Left = Left;
+    term.Right = Right;
+    term.Nullable = Nullable;
+    auto iter = this->termIds.find(term);
+    if (iter != this->termIds.end())
+        return iter->second;
+
+    auto id = (uint32_t)this->terms.size();
+    this->terms.push_back(term);
+    this->termIds[term] = id;
+    return id;
+}
+
+/// \brief Creates the term for a single symbol.
+uint32_t DerivativeCompiler::MakeLiteral(uint32_t Symbol)
+{
+    return this->Intern(LiteralTerm, Symbol, 0, false);
+}
+
+/// \brief Creates the concatenation of the given terms.
+uint32_t DerivativeCompiler::MakeConcat(uint32_t Left, uint32_t Right)
+{
+    if (Left == Phi || Right == Phi)
+        return Phi;
+    else if (Left == Epsilon)
+        return Right;
+    else if (Right == Epsilon)
+        return Left;
+
+    auto left = this->terms[Left];
+    if (left.Kind == ConcatTerm)
+        return this->MakeConcat(left.Left, this->MakeConcat(left.Right, Right));
+
+    return this->Intern(ConcatTerm, Left, Right, left.Nullable && this->terms[Right].Nullable);
+}
+
+/// \brief Creates the union of the given terms.
+uint32_t DerivativeCompiler::MakeUnion(uint32_t Left, uint32_t Right)
+{
+    if (Left == Right || Right == Phi)
+        return Left;
+    else if (Left == Phi)
+        return Right;
+
+    // Unions are stored as right-nested chains of distinct,
+    // ascending operands, which makes them associative, commutative
+    // and idempotent up to term identity.
+    std::vector<uint32_t> operands;
+    this->AddUnionOperands(Left, operands);
+    this->AddUnionOperands(Right, operands);
+    std::sort(operands.begin(), operands.end());
+    operands.erase(std::unique(operands.begin(), operands.end()), operands.end());
+
+    auto result = operands.back();
+    for (auto i = operands.size() - 1; i > 0; i--)
+    {
+        auto operand = operands[i - 1];
+        result = this->Intern(UnionTerm, operand, result, this->terms[operand].Nullable || this->terms[result].Nullable);
+    }
+    return result;
+}
+
+/// \brief Creates the closure of the given term.
+uint32_t DerivativeCompiler::MakeClosure(uint32_t Operand)
+{
+    if (Operand == Phi || Operand == Epsilon)
+        return Epsilon;
+    else if (this->terms[Operand].Kind == ClosureTerm)
+        return Operand;
+    else
+        return this->Intern(ClosureTerm, Operand, 0, true);
+}
+
+/// \brief Adds the operands of the given union term, or the term
+/// itself if it is not a union, to the given vector.
+void DerivativeCompiler::AddUnionOperands(uint32_t Id, std::vector<uint32_t>& Operands) const
+{
+    while (this->terms[Id].Kind == UnionTerm)
+    {
+        Operands.push_back(this->terms[Id].Left);
+        Id = this->terms[Id].Right;
+    }
+    Operands.push_back(Id);
+}
+
+/// \brief Converts the given regex to a term.
+uint32_t DerivativeCompiler::Convert(const IRegex* Regex)
+{
+    switch (Regex->getKind())
+    {
+    case LiteralKind:
+        return this->MakeLiteral(this->symbols.Intern(dynamic_cast<const LiteralRegex*>(Regex)->Literal));
+    case ConcatKind:
+    {
+        auto concat = dynamic_cast<const ConcatRegex*>(Regex);
+        return this->MakeConcat(this->Convert(concat->Left.get()), this->Convert(concat->Right.get()));
+    }
+    case UnionKind:
+    {
+        auto unionRegex = dynamic_cast<const UnionRegex*>(Regex);
+        return this->MakeUnion(this->Convert(unionRegex->Left.get()), this->Convert(unionRegex->Right.get()));
+    }
+    case ClosureKind:
+        return this->MakeClosure(this->Convert(dynamic_cast<const ClosureRegex*>(Regex)->Regex.get()));
+    case EpsilonKind:
+        return Epsilon;
+    case PhiKind:
+        return Phi;
+    default:
+        throw std::invalid_argument("Regex '" + Regex->ToString() + "' cannot be compiled by taking derivatives.");
+    }
+}
+
+/// \brief Computes the derivative of the given term with respect
+/// to the given symbol.
+uint32_t DerivativeCompiler::Derive(uint32_t Id, uint32_t Symbol)
+{
+    auto key = (uint64_t)Id << 32 | Symbol;
+    auto iter = this->derivatives.find(key);
+    if (iter != this->derivatives.end())
+        return iter->second;
+
+    auto term = this->terms[Id];
+    uint32_t result;
+    switch (term.Kind)
+    {
+    case LiteralTerm:
+        result = term.Left == Symbol ? Epsilon : Phi;
+        break;
+    case ConcatTerm:
+        result = this->MakeConcat(this->Derive(term.Left, Symbol), term.Right);
+        if (this->terms[term.Left].Nullable)
+            result = this->MakeUnion(result, this->Derive(term.Right, Symbol));
+        break;
+    case UnionTerm:
+        result = this->MakeUnion(this->Derive(term.Left, Symbol), this->Derive(term.Right, Symbol));
+        break;
+    case ClosureTerm:
+        result = this->MakeConcat(this->Derive(term.Left, Symbol), Id);
+        break;
+    default:
+        result = Phi;
+        break;
+    }
+    this->derivatives[key] = result;
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "CompiledDFA.h"
+#include "IRegex.h"
+#include "SymbolTable.h"
+
+namespace Automata
+{
+    /// \brief Defines a compiler that turns regexes into DFAs by taking
+    /// Brzozowski derivatives. Regexes are converted to hash-consed
+    /// terms, which are built by smart constructors that normalize
+    /// them: unions are flattened, sorted and deduplicated, concats
+    /// are right-associated, and the identities of phi, epsilon and
+    /// closure are applied. Every distinct derivative of the regex is
+    /// a DFA state, so no epsilon transitions or subsets are ever
+    /// created, and the resulting DFA is usually close to minimal.
+    /// Derivatives are memoized per (term, symbol) pair.
+    class DerivativeCompiler
+    {
+    public:
+        /// \brief Creates a derivative compiler.
+        DerivativeCompiler();
+
+        /// \brief Compiles the given regex, which must consist of
+        /// literal, concat, union, closure, epsilon and phi regexes,
+        /// to a DFA. State zero is the dead state, which is the phi
+        /// term. The DFA's alphabet consists of all symbols this
+        /// compiler has seen.
+        CompiledDFA<std::string> Compile(const IRegex* Regex);
+
+        /// \brief Gets the number of terms that have been created.
+        uint32_t getTermCount() const;
+    private:
+        /// \brief Lists the kinds of terms.
+        enum TermKind
+        {
+            PhiTerm,
+            EpsilonTerm,
+            LiteralTerm,
+            ConcatTerm,
+            UnionTerm,
+            ClosureTerm
+        };
+
+        /// \brief Describes a term. Literals store their symbol id in
+        /// Left; closures store their operand in Left.
+        struct Term
+        {
+            TermKind Kind;
+            uint32_t Left;
+            uint32_t Right;
+            bool Nullable;
+        };
+
+        /// \brief Hashes the kind and operands of a term.
+        struct TermHash
+        {
+            std::size_t operator()(const Term& Value) const;
+        };
+
+        /// \brief Compares the kind and operands of two terms.
+        struct TermEquals
+        {
+            bool operator()(const Term& Left, const Term& Right) const;
+        };
+
+        /// \brief The id of the phi term.
+        static const uint32_t Phi = 0;
+
+        /// \brief The id of the epsilon term.
+        static const uint32_t Epsilon = 1;
+
+        /// \brief Finds or creates the term with the given kind and
+        /// operands.
+        uint32_t Intern(TermKind Kind, uint32_t Left, uint32_t Right, bool Nullable);
+
+        /// \brief Creates the term for a single symbol.
+        uint32_t MakeLiteral(uint32_t Symbol);
+
+        /// \brief Creates the concatenation of the given terms.
+        uint32_t MakeConcat(uint32_t Left, uint32_t Right);
+
+        /// \brief Creates the union of the given terms.
+        uint32_t MakeUnion(uint32_t Left, uint32_t Right);
+
+        /// \brief Creates the closure of the given term.
+        uint32_t MakeClosure(uint32_t Operand);
+
+        /// \brief Adds the operands of the given union term, or the term
+        /// itself if it is not a union, to the given vector.
+        void AddUnionOperands(uint32_t Id, std::vector<uint32_t>& Operands) const;
+
+        /// \brief Converts the given regex to a term.
+        uint32_t Convert(const IRegex* Regex);
+
+        /// \brief Computes the derivative of the given term with respect
+        /// to the given symbol.
+        uint32_t Derive(uint32_t Id, uint32_t Symbol);
+
+        SymbolTable<std::string> symbols;
+        std::vector<Term> terms;
+        std::unordered_map<Term, uint32_t, TermHash, TermEquals> termIds;
+        std::unordered_map<uint64_t, uint32_t> derivatives;
+    };
+}
\ No newline at end of file
@@ -1,15 +1,27 @@
 #pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 #include "ArraySlice.h"
+#include "CompiledNFA.h"
 #include "DFAutomaton.h"
 #include "IAutomaton.h"
 #include "IFunction.h"
+#include "LazyDFA.h"
 #include "LinearSet.h"
 #include "Optional.h"
+#include "SparseSet.h"
+#include "SymbolTable.h"
 #include "TransitionTable.h"
 
 namespace Automata
 {
+    template<typename TState, typename TChar>
+    class NFAutomaton;
+
     /// \brief Defines a non-deterministic finite automaton with epsilon
     /// transitions.
     template<typename TState, typename TChar>
@@ -25,6 +37,22 @@ namespace Automata
         /// string of symbols.
         bool Accepts(stdx::ArraySlice<TChar> Characters) const override;
 
+        /// \brief Compiles this automaton to integer state and symbol ids,
+        /// with its edges in compressed sparse row form. The start
+        /// state is assigned id zero.
+        CompiledNFA<TChar> Compile() const;
+
+        /// \brief Compiles this automaton to integer state and symbol ids,
+        /// and stores the original state that corresponds to each
+        /// state id in the given vector.
+        CompiledNFA<TChar> Compile(std::vector<TState>& States) const;
+
+        /// \brief Compiles this automaton, numbering its symbols with the
+        /// given symbol table, which is extended with any symbols it
+        /// does not contain yet. The original state that corresponds to
+        /// each state id is stored in the given vector.
+        CompiledNFA<TChar> Compile(const SymbolTable<TChar>& Symbols, std::vector<TState>& States) const;
+
         /// \brief Finds out whether the given sequence of states has a
         /// non-empty intersection with the set of accepting states.
         bool ContainsAcceptingState(LinearSet<TState> States) const;
@@ -48,7 +76,7 @@ namespace Automata
         LinearSet<TState> GetStates() const;
 
         /// \brief Gets the e-NFA's transition function.
-        TransitionTable<std::pair<TState, Optional<TChar>>, LinearSet<TState>> getTransitionFunction() const;
+        const TransitionTable<std::pair<TState, Optional<TChar>>, LinearSet<TState>>& getTransitionFunction() const;
 
         /// \brief Returns the set of all states reachable by performing a
         /// single transition with the given character for each state
@@ -66,6 +94,11 @@ namespace Automata
         /// given).
         LinearSet<TState> PerformTransition(TState State, Optional<TChar> Character) const;
 
+        /// \brief Creates an equivalent NFA by folding epsilon-closures into
+        /// the transitions and accepting states. Only the states that
+        /// are reachable from the start state are kept.
+        NFAutomaton<TState, TChar> RemoveEpsilons() const;
+
         /// \brief Creates a new e-NFA by renaming this e-NFA's states and
         /// symbols.
         template<typename TNState, typename TNChar>
@@ -76,7 +109,7 @@ namespace Automata
             auto oldAccept = this->getAcceptingStates();
             for (auto& val : oldAccept.getItems())
                 newAccept.Add(StateRenamer->Apply(val));
-            auto currentTransFun = this->getTransitionFunction();
+            auto& currentTransFun = this->getTransitionFunction();
             std::unordered_map<std::pair<TNState, Optional<TNChar>>, LinearSet<TNState>> newTransMap;
             for (auto& item : currentTransFun.getMap())
             {
@@ -100,6 +133,36 @@ namespace Automata
         /// automaton.
         DFAutomaton<LinearSet<TState>, TChar> ToDFAutomaton() const;
     private:
+        /// \brief Holds an automaton's compiled form, along with the
+        /// mapping between its states and their ids, and a lazy DFA
+        /// that caches the subsets that Accepts visits. The compiled
+        /// form is created exactly once, even if several threads ask
+        /// for it at the same time; the lazy DFA is only used by one
+        /// thread at a time.
+        struct CompiledForm
+        {
+            std::once_flag Compiled;
+            std::shared_ptr<const CompiledNFA<TChar>> Automaton;
+            std::vector<TState> States;
+            std::unordered_map<TState, uint32_t> StateIds;
+            std::mutex MatcherLock;
+            std::unique_ptr<LazyDFA<TChar>> Matcher;
+        };
+
+        /// \brief Gets this automaton's compiled form, which is created on
+        /// first use and shared by all copies of this automaton. The
+        /// compiled form's epsilon-closures are precomputed.
+        CompiledForm& GetCompiledForm() const;
+
+        /// \brief Converts the given set of states to a set of state ids
+        /// of the compiled automaton. States that do not occur in the
+        /// automaton are skipped.
+        void GetStateIds(const LinearSet<TState>& States, SparseSet& Result) const;
+
+        /// \brief Converts the given set of state ids of the compiled
+        /// automaton to a set of states.
+        LinearSet<TState> GetStates(const SparseSet& Ids) const;
+
         /// \brief Sets the e-NFA's set of accepting states.
         void setAcceptingStates(LinearSet<TState> value);
 
@@ -109,13 +172,10 @@ namespace Automata
         /// \brief Sets the e-NFA's transition function.
         void setTransitionFunction(TransitionTable<std::pair<TState, Optional<TChar>>, LinearSet<TState>> value);
 
-        /// \brief Performs the modified subset construction based on the
-        /// given alphabet.
-        DFAutomaton<LinearSet<TState>, TChar> ToDFAutomaton(LinearSet<TChar> Alphabet) const;
-
         LinearSet<TState> AcceptingStates_value;
         TState StartState_value;
         TransitionTable<std::pair<TState, Optional<TChar>>, LinearSet<TState>> TransitionFunction_value;
+        std::shared_ptr<CompiledForm> Compiled_value;
     };
 }
 
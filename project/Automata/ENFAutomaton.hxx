@@ -1,13 +1,22 @@
 #include "ENFAutomaton.h"
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 #include "ArraySlice.h"
+#include "CompiledNFA.h"
 #include "DFAutomaton.h"
 #include "IAutomaton.h"
 #include "IFunction.h"
+#include "LazyDFA.h"
 #include "LinearSet.h"
 #include "Optional.h"
+#include "SparseSet.h"
+#include "SubsetTable.h"
+#include "SymbolTable.h"
 #include "TransitionTable.h"
 
 using namespace Automata;
@@ -21,6 +30,7 @@ ENFAutomaton<TState, TChar>::ENFAutomaton(TState StartState, LinearSet<TState> A
     this->setStartState(StartState);
     this->setAcceptingStates(AcceptingStates);
     this->setTransitionFunction(TransitionFunction);
+    this->Compiled_value = std::make_shared<CompiledForm>();
 }
 
 /// \brief Figures out whether this automaton accepts the given
@@ -28,8 +38,86 @@ ENFAutomaton<TState, TChar>::ENFAutomaton(TState StartState, LinearSet<TState> A
 template<typename TState, typename TChar>
 bool ENFAutomaton<TState, TChar>::Accepts(stdx::ArraySlice<TChar> Characters) const
 {
-    return this->ContainsAcceptingState(this->PerformExtendedTransition(this->getStartState(), 
-                                                                        Characters));
+    // Determinize lazily: only the subsets that the input actually
+    // reaches are constructed. The shared lazy DFA keeps its subsets
+    // from one call to the next; a thread that finds it in use runs a
+    // private one instead of waiting.
+    auto& compiled = this->GetCompiledForm();
+    std::unique_lock<std::mutex> lock(compiled.MatcherLock, std::try_to_lock);
+    if (lock.owns_lock())
+        return compiled.Matcher->Accepts(Characters);
+    LazyDFA<TChar> dfa(compiled.Automaton);
+    return dfa.Accepts(Characters);
+}
+
+/// \brief Compiles this automaton to integer state and symbol ids,
+/// with its edges in compressed sparse row form. The start
+/// state is assigned id zero.
+template<typename TState, typename TChar>
+CompiledNFA<TChar> ENFAutomaton<TState, TChar>::Compile() const
+{
+    std::vector<TState> states;
+    return this->Compile(states);
+}
+
+/// \brief Compiles this automaton to integer state and symbol ids,
+/// and stores the original state that corresponds to each
+/// state id in the given vector.
+template<typename TState, typename TChar>
+CompiledNFA<TChar> ENFAutomaton<TState, TChar>::Compile(std::vector<TState>& States) const
+{
+    return this->Compile(SymbolTable<TChar>(), States);
+}
+
+/// \brief Compiles this automaton, numbering its symbols with the
+/// given symbol table, which is extended with any symbols it
+/// does not contain yet. The original state that corresponds to
+/// each state id is stored in the given vector.
+template<typename TState, typename TChar>
+CompiledNFA<TChar> ENFAutomaton<TState, TChar>::Compile(const SymbolTable<TChar>& Symbols, std::vector<TState>& States) const
+{
+    std::unordered_map<TState, uint32_t> stateIds;
+    auto symbols = Symbols;
+    States.clear();
+    auto getStateId = [&](const TState& State) -> uint32_t
+    {
+        auto iter = stateIds.find(State);
+        if (iter != stateIds.end())
+            return iter->second;
+        auto id = (uint32_t)States.size();
+        stateIds[State] = id;
+        States.push_back(State);
+        return id;
+    };
+    auto startId = getStateId(this->getStartState());
+    std::vector<uint32_t> edges;
+    std::vector<uint32_t> epsilonEdges;
+    for (auto& item : this->getTransitionFunction().getMap())
+    {
+        auto source = getStateId(item.first.first);
+        if (!item.first.second.HasValue)
+        {
+            for (auto& target : item.second.getItems())
+            {
+                epsilonEdges.push_back(source);
+                epsilonEdges.push_back(getStateId(target));
+            }
+            continue;
+        }
+
+        auto symbol = symbols.Intern(item.first.second.Value);
+        for (auto& target : item.second.getItems())
+        {
+            edges.push_back(source);
+            edges.push_back(symbol);
+            edges.push_back(getStateId(target));
+        }
+    }
+    std::vector<uint32_t> acceptingIds;
+    for (auto& q : this->getAcceptingStates().getItems())
+        acceptingIds.push_back(getStateId(q));
+
+    return CompiledNFA<TChar>(symbols, (uint32_t)States.size(), startId, acceptingIds, edges, epsilonEdges);
 }
 
 /// \brief Finds out whether the given sequence of states has a
@@ -46,32 +134,24 @@ bool ENFAutomaton<TState, TChar>::ContainsAcceptingState(LinearSet<TState> State
 template<typename TState, typename TChar>
 LinearSet<TState> ENFAutomaton<TState, TChar>::Eclose(TState State) const
 {
-    LinearSet<TState> results;
-    LinearSet<TState> step;
-    step.Add(State);
-    while (!step.getIsEmpty())
-    {
-        auto last = step.getLast();
-        results.Add(last);
-        step.RemoveLast();
-        LinearSet<TState> nextStep;
-        auto trans = this->PerformTransition(last, Optional<TChar>());
-        for (auto& item : trans.getItems())
-            if (!results.Contains(item))
-                step.Add(item);
-
-    }
-    return results;
+    return this->Eclose(LinearSet<TState>(State));
 }
 
 /// \brief Computes the epsilon-closure of the given set of states.
 template<typename TState, typename TChar>
 LinearSet<TState> ENFAutomaton<TState, TChar>::Eclose(LinearSet<TState> States) const
 {
-    LinearSet<TState> vals;
+    auto& compiled = this->GetCompiledForm();
+    SparseSet ids;
+    this->GetStateIds(States, ids);
+    compiled.Automaton->Eclose(ids);
+    auto results = this->GetStates(ids);
+    // States that do not occur in the automaton have no edges, so they
+    // are their own closures.
     for (auto& item : States.getItems())
-        vals.AddAll(this->Eclose(item));
-    return vals;
+        if (compiled.StateIds.find(item) == compiled.StateIds.end())
+            results.Add(item);
+    return results;
 }
 
 /// \brief Gets the automaton's alphabet.
@@ -79,7 +159,7 @@ template<typename TState, typename TChar>
 LinearSet<TChar> ENFAutomaton<TState, TChar>::GetAlphabet() const
 {
     LinearSet<TChar> results;
-    auto transfunc = this->getTransitionFunction();
+    auto& transfunc = this->getTransitionFunction();
     for (auto& item : transfunc.getMap())
         if (item.first.second.HasValue)
             results.Add(item.first.second.Value);
@@ -92,7 +172,7 @@ template<typename TState, typename TChar>
 LinearSet<TState> ENFAutomaton<TState, TChar>::GetStates() const
 {
     LinearSet<TState> results;
-    auto transfunc = this->getTransitionFunction();
+    auto& transfunc = this->getTransitionFunction();
     for (auto& item : transfunc.getMap())
     {
         results.Add(item.first.first);
@@ -120,13 +200,21 @@ LinearSet<TState> ENFAutomaton<TState, TChar>::PerformAllTransitions(LinearSet<T
 template<typename TState, typename TChar>
 LinearSet<TState> ENFAutomaton<TState, TChar>::PerformExtendedTransition(TState State, stdx::ArraySlice<TChar> Characters) const
 {
-    auto states = this->Eclose(State);
-    for (auto& item : Characters)
+    auto& compiled = this->GetCompiledForm();
+    auto start = compiled.StateIds.find(State);
+    if (start == compiled.StateIds.end())
     {
-        Optional<TChar> optItem(item);
-        states = this->Eclose(this->PerformAllTransitions(states, optItem));
+        // A state that does not occur in the automaton has no edges.
+        if (Characters.GetLength() == 0)
+            return LinearSet<TState>(State);
+        else
+            return LinearSet<TState>();
     }
-    return states;
+
+    auto symbols = compiled.Automaton->TranslateSymbols(Characters);
+    SparseSet result;
+    compiled.Automaton->PerformExtendedTransition(start->second, symbols.data(), symbols.size(), result);
+    return this->GetStates(result);
 }
 
 /// \brief Performs a state transition that starts at the given
@@ -135,60 +223,116 @@ LinearSet<TState> ENFAutomaton<TState, TChar>::PerformExtendedTransition(TState
 template<typename TState, typename TChar>
 LinearSet<TState> ENFAutomaton<TState, TChar>::PerformTransition(TState State, Optional<TChar> Character) const
 {
-    auto transFun = this->getTransitionFunction();
-    return transFun.Apply(std::pair<TState, Optional<TChar>>(State, Character));
+    return this->getTransitionFunction().Apply(std::pair<TState, Optional<TChar>>(State, Character));
 }
 
 
+/// \brief Creates an equivalent NFA by folding epsilon-closures into
+/// the transitions and accepting states. Only the states that
+/// are reachable from the start state are kept.
+template<typename TState, typename TChar>
+NFAutomaton<TState, TChar> ENFAutomaton<TState, TChar>::RemoveEpsilons() const
+{
+    auto& compiled = this->GetCompiledForm();
+    std::vector<uint32_t> ids;
+    auto nfa = compiled.Automaton->RemoveEpsilons(ids);
+    auto& states = compiled.States;
+    auto& edgeOffsets = nfa.getEdgeOffsets();
+    auto& edgeSymbols = nfa.getEdgeSymbols();
+    auto& edgeTargets = nfa.getEdgeTargets();
+    std::unordered_map<std::pair<TState, TChar>, LinearSet<TState>> transMap;
+    for (uint32_t q = 0; q < nfa.getStateCount(); q++)
+    {
+        // A state's edges are sorted by symbol, and have no duplicates.
+        auto i = edgeOffsets[q];
+        while (i < edgeOffsets[q + 1])
+        {
+            auto symbol = edgeSymbols[i];
+            std::vector<TState> targets;
+            for (; i < edgeOffsets[q + 1] && edgeSymbols[i] == symbol; i++)
+                targets.push_back(states[ids[edgeTargets[i]]]);
+            transMap[std::pair<TState, TChar>(states[ids[q]], nfa.getSymbols()[symbol])] = LinearSet<TState>(targets);
+        }
+    }
+    std::vector<TState> accepting;
+    for (auto q : nfa.getAcceptingStates())
+        accepting.push_back(states[ids[q]]);
+    return NFAutomaton<TState, TChar>(this->getStartState(), LinearSet<TState>(accepting),
+                                      TransitionTable<std::pair<TState, TChar>, LinearSet<TState>>(transMap));
+}
+
 /// \brief Performs the modified subset construction on this
 /// automaton.
 template<typename TState, typename TChar>
 DFAutomaton<LinearSet<TState>, TChar> ENFAutomaton<TState, TChar>::ToDFAutomaton() const
 {
-    return this->ToDFAutomaton(this->GetAlphabet());
+    auto& compiled = this->GetCompiledForm();
+    auto& states = compiled.States;
+    SubsetTable subsets;
+    auto dfa = compiled.Automaton->Determinize(subsets, 0);
+    std::vector<LinearSet<TState>> names;
+    names.reserve(subsets.getCount());
+    for (uint32_t id = 0; id < subsets.getCount(); id++)
+    {
+        std::vector<TState> subset;
+        for (auto q : subsets.GetSubset(id))
+            subset.push_back(states[q]);
+        names.push_back(LinearSet<TState>(subset));
+    }
+    return dfa.ToDFAutomaton(names);
+}
+
+/// \brief Gets the e-NFA's set of accepting states.
+template<typename TState, typename TChar>
+LinearSet<TState> ENFAutomaton<TState, TChar>::getAcceptingStates() const
+{
+    return this->AcceptingStates_value;
 }
 
-/// \brief Performs the modified subset construction based on the
-/// given alphabet.
+/// \brief Gets this automaton's compiled form, which is created on
+/// first use and shared by all copies of this automaton. The
+/// compiled form's epsilon-closures are precomputed.
 template<typename TState, typename TChar>
-DFAutomaton<LinearSet<TState>, TChar> ENFAutomaton<TState, TChar>::ToDFAutomaton(LinearSet<TChar> Alphabet) const
+typename ENFAutomaton<TState, TChar>::CompiledForm& ENFAutomaton<TState, TChar>::GetCompiledForm() const
 {
-    auto startState = this->Eclose(this->getStartState());
-    std::unordered_map<std::pair<LinearSet<TState>, TChar>, LinearSet<TState>> transMap;
-    LinearSet<LinearSet<TState>> accStates;
-    LinearSet<LinearSet<TState>> processedStates;
-    LinearSet<LinearSet<TState>> nextStates;
-    nextStates.Add(startState);
-    while (!nextStates.getIsEmpty())
+    auto& compiled = *this->Compiled_value;
+    std::call_once(compiled.Compiled, [&]()
     {
-        auto last = nextStates.getLast();
-        LinearSet<LinearSet<TState>> accumulatedStates;
-        if (!processedStates.Contains(last))
-        {
-            for (auto& item : Alphabet.getItems())
-            {
-                auto trans = this->Eclose(this->PerformAllTransitions(last, Optional<TChar>(item)));
-                accumulatedStates.Add(trans);
-                transMap[std::pair<LinearSet<TState>, TChar>(last, item)] = trans;
-            }
-            processedStates.Add(last);
-            if (this->ContainsAcceptingState(last))
-                accStates.Add(last);
+        compiled.Automaton = std::make_shared<CompiledNFA<TChar>>(this->Compile(compiled.States));
+        for (uint32_t i = 0; i < (uint32_t)compiled.States.size(); i++)
+            compiled.StateIds[compiled.States[i]] = i;
+        compiled.Matcher.reset(new LazyDFA<TChar>(compiled.Automaton));
+    });
+    return compiled;
+}
 
-        }
-        nextStates.RemoveLast();
-        nextStates.AddAll(accumulatedStates);
+/// \brief Converts the given set of states to a set of state ids
+/// of the compiled automaton. States that do not occur in the
+/// automaton are skipped.
+template<typename TState, typename TChar>
+void ENFAutomaton<TState, TChar>::GetStateIds(const LinearSet<TState>& States, SparseSet& Result) const
+{
+    auto& compiled = this->GetCompiledForm();
+    Result.Resize(compiled.Automaton->getStateCount());
+    for (auto& item : States.getItems())
+    {
+        auto iter = compiled.StateIds.find(item);
+        if (iter != compiled.StateIds.end())
+            Result.Add(iter->second);
     }
-    TransitionTable<std::pair<LinearSet<TState>, TChar>, LinearSet<TState>> transFun(transMap);
-    return DFAutomaton<LinearSet<TState>, TChar>(startState, 
-                                                 accStates, transFun);
 }
 
-/// \brief Gets the e-NFA's set of accepting states.
+/// \brief Converts the given set of state ids of the compiled
+/// automaton to a set of states.
 template<typename TState, typename TChar>
-LinearSet<TState> ENFAutomaton<TState, TChar>::getAcceptingStates() const
+LinearSet<TState> ENFAutomaton<TState, TChar>::GetStates(const SparseSet& Ids) const
 {
-    return this->AcceptingStates_value;
+    auto& states = this->GetCompiledForm().States;
+    std::vector<TState> results;
+    results.reserve(Ids.getCount());
+    for (auto q : Ids.getItems())
+        results.push_back(states[q]);
+    return LinearSet<TState>(results);
 }
 
 /// \brief Sets the e-NFA's set of accepting states.
@@ -214,7 +358,7 @@ void ENFAutomaton<TState, TChar>::setStartState(TState value)
 
 /// \brief Gets the e-NFA's transition function.
 template<typename TState, typename TChar>
-TransitionTable<std::pair<TState, Optional<TChar>>, LinearSet<TState>> ENFAutomaton<TState, TChar>::getTransitionFunction() const
+const TransitionTable<std::pair<TState, Optional<TChar>>, LinearSet<TState>>& ENFAutomaton<TState, TChar>::getTransitionFunction() const
 {
     return this->TransitionFunction_value;
 }
@@ -224,4 +368,6 @@ template<typename TState, typename TChar>
 void ENFAutomaton<TState, TChar>::setTransitionFunction(TransitionTable<std::pair<TState, Optional<TChar>>, LinearSet<TState>> value)
 {
     this->TransitionFunction_value = value;
-}
\ No newline at end of file
+}
+
+#include "NFAutomaton.h"
\ No newline at end of file
@@ -1,42 +1,43 @@
 #include "EpsilonRegex.h"
 
+#include <cstddef>
 #include <memory>
 #include <string>
-#include <unordered_map>
-#include <utility>
-#include "ENFAutomaton.h"
 #include "IRegex.h"
-#include "LinearSet.h"
-#include "Optional.h"
-#include "RegexState.h"
-#include "TransitionTable.h"
+#include "ThompsonBuilder.h"
 
 using namespace Automata;
 
 EpsilonRegex::EpsilonRegex()
 { }
 
-/// \brief Constructs an epsilon-nfa for this regex.
+/// \brief Appends this regex's e-NFA to the given builder.
 /// The construction is as follows:    start -> end.
-/// where 'start' is the initial state, 'end' is an accepting
-/// state, and '->' is an epsilon-transition.
-ENFAutomaton<std::shared_ptr<RegexState>, std::string> EpsilonRegex::ToENFAutomaton() const
+/// where 'start' is the fragment's start state, 'end' is its
+/// accepting state, and '->' is an epsilon-transition.
+RegexFragment EpsilonRegex::AppendENFAutomaton(ThompsonBuilder& Builder) const
 {
-    auto startState = std::make_shared<RegexState>();
-    LinearSet<std::shared_ptr<RegexState>> acceptingStates;
-    acceptingStates.Add(std::make_shared<RegexState>());
-    std::unordered_map<std::pair<std::shared_ptr<RegexState>, Optional<std::string>>, LinearSet<std::shared_ptr<RegexState>>> transitions;
-    std::pair<std::shared_ptr<RegexState>, Optional<std::string>> label(startState, 
-                                                                        Optional<std::string>());
-    transitions[label] = acceptingStates;
-    TransitionTable<std::pair<std::shared_ptr<RegexState>, Optional<std::string>>, LinearSet<std::shared_ptr<RegexState>>> transTable(transitions);
-    return ENFAutomaton<std::shared_ptr<RegexState>, std::string>(startState, 
-                                                                  acceptingStates, 
-                                                                  transTable);
+    auto startState = Builder.CreateState();
+    auto endState = Builder.CreateState();
+    Builder.AddEpsilonTransition(startState, endState);
+    return RegexFragment(startState, endState);
 }
 
 /// \brief Gets this regex's string representation.
 std::string EpsilonRegex::ToString() const
 {
     return "\\e";
+}
+
+/// \brief Gets this regex's hash code, which depends on its
+/// structure only, and is computed when the regex is created.
+std::size_t EpsilonRegex::getHashCode() const
+{
+    return (std::size_t)EpsilonKind;
+}
+
+/// \brief Gets this regex's kind.
+RegexKind EpsilonRegex::getKind() const
+{
+    return EpsilonKind;
 }
\ No newline at end of file
@@ -1,9 +1,10 @@
 #pragma once
+#include <cstddef>
 #include <memory>
 #include <string>
 #include "ENFAutomaton.h"
 #include "IRegex.h"
-#include "RegexState.h"
+#include "ThompsonBuilder.h"
 
 namespace Automata
 {
@@ -12,13 +13,20 @@ namespace Automata
     {
         EpsilonRegex();
 
-        /// \brief Constructs an epsilon-nfa for this regex.
+        /// \brief Appends this regex's e-NFA to the given builder.
         /// The construction is as follows:    start -> end.
-        /// where 'start' is the initial state, 'end' is an accepting
-        /// state, and '->' is an epsilon-transition.
-        ENFAutomaton<std::shared_ptr<RegexState>, std::string> ToENFAutomaton() const override;
+        /// where 'start' is the fragment's start state, 'end' is its
+        /// accepting state, and '->' is an epsilon-transition.
+        RegexFragment AppendENFAutomaton(ThompsonBuilder& Builder) const override;
 
         /// \brief Gets this regex's string representation.
         std::string ToString() const override;
+
+        /// \brief Gets this regex's hash code, which depends on its
+        /// structure only, and is computed when the regex is created.
+        std::size_t getHashCode() const override;
+
+        /// \brief Gets this regex's kind.
+        RegexKind getKind() const override;
     };
 }
\ No newline at end of file
@@ -0,0 +1,222 @@
+#include "GlushkovMatcher.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ArraySlice.h"
+#include "CompiledNFA.h"
+#include "IRegex.h"
+#include "LazyDFA.h"
+#include "PositionAutomaton.h"
+#include "SymbolTable.h"
+
+using namespace Automata;
+
+const uint32_t GlushkovMatcher::MaxPositions;
+
+/// \brief Creates a matcher for the given regex, which must
+/// consist of literal, concat, union, closure, epsilon and phi
+/// regexes.
+GlushkovMatcher::GlushkovMatcher(std::shared_ptr<IRegex> Regex)
+{
+    PositionAutomaton positions(Regex.get());
+    this->symbols = positions.getSymbolTable();
+    this->positionCount = positions.getPositionCount();
+    this->wordCount = (this->positionCount + 1 + 63) / 64;
+    this->chunkCount = (this->positionCount + 1 + 7) / 8;
+
+    if (this->positionCount > MaxPositions)
+    {
+        // The position automaton is an NFA whose edge from p to q is
+        // labeled with q's symbol.
+        std::vector<uint32_t> edges;
+        for (uint32_t p = 0; p <= this->positionCount; p++)
+        {
+            for (auto q : positions.GetFollow(p))
+            {
+                edges.push_back(p);
+                edges.push_back(positions.GetLabel(q));
+                edges.push_back(q);
+            }
+        }
+        this->fallback = std::make_shared<CompiledNFA<std::string>>(this->symbols, this->positionCount + 1, 0,
+                                                                    positions.getFinalPositions(), edges,
+                                                                    std::vector<uint32_t>());
+        this->fallbackMatcher.reset(new LazyDFA<std::string>(this->fallback));
+        return;
+    }
+
+    this->finalMask.assign(this->wordCount, 0);
+    for (auto p : positions.getFinalPositions())
+        this->finalMask[p / 64] |= (uint64_t)1 << (p % 64);
+
+    auto symbolCount = this->symbols.getCount();
+    this->symbolMasks.assign((std::size_t)(symbolCount + 1) * this->wordCount, 0);
+    for (uint32_t p = 1; p <= this->positionCount; p++)
+        this->symbolMasks[(std::size_t)positions.GetLabel(p) * this->wordCount + p / 64] |= (uint64_t)1 << (p % 64);
+
+    // Entry (c, v) is the union of the follow sets of the positions
+    // whose bits are set in byte value v of chunk c.
+    this->followTable.assign((std::size_t)this->chunkCount * 256 * this->wordCount, 0);
+    for (uint32_t c = 0; c < this->chunkCount; c++)
+    {
+        for (uint32_t v = 1; v < 256; v++)
+        {
+            auto entry = &this->followTable[((std::size_t)c * 256 + v) * this->wordCount];
+            for (uint32_t bit = 0; bit < 8; bit++)
+            {
+                auto p = c * 8 + bit;
+                if ((v >> bit & 1) == 0 || p > this->positionCount)
+                    continue;
+                for (auto q : positions.GetFollow(p))
+                    entry[q / 64] |= (uint64_t)1 << (q % 64);
+            }
+        }
+    }
+}
+
+/// \brief Figures out whether this matcher accepts the given
+/// string of symbols.
+bool GlushkovMatcher::Accepts(stdx::ArraySlice<std::string> Characters) const
+{
+    auto ids = this->symbols.Translate(Characters, this->getSymbolCount());
+    return this->Accepts(ids.data(), ids.size());
+}
+
+/// \brief Figures out whether this matcher accepts the given
+/// string of symbol ids.
+bool GlushkovMatcher::Accepts(const uint32_t* Symbols, std::size_t Length) const
+{
+    if (!this->IsBitParallel())
+        return this->RunFallback([=](const LazyDFA<std::string>& Dfa) { return Dfa.Accepts(Symbols, Length); });
+
+    return this->Run(Length, [=](std::size_t Index) { return Symbols[Index]; });
+}
+
+/// \brief Figures out whether this matcher accepts the given
+/// string of bytes.
+bool GlushkovMatcher::Accepts(const char* Data, std::size_t Length) const
+{
+    if (!this->IsBitParallel())
+        return this->RunFallback([=](const LazyDFA<std::string>& Dfa) { return Dfa.Accepts(Data, Length); });
+
+    auto byteIds = this->symbols.getByteIds();
+    auto other = this->getSymbolCount();
+    return this->Run(Length, [=](std::size_t Index) -> uint32_t
+    {
+        auto id = byteIds[(unsigned char)Data[Index]];
+        return id == SymbolTable<std::string>::NoSymbol ? other : id;
+    });
+}
+
+/// \brief Gets the id of the given symbol. Symbols that do not
+/// occur in the regex are mapped to getSymbolCount().
+uint32_t GlushkovMatcher::GetSymbolId(const std::string& Symbol) const
+{
+    auto id = this->symbols.GetId(Symbol);
+    return id == SymbolTable<std::string>::NoSymbol ? this->getSymbolCount() : id;
+}
+
+/// \brief Gets the number of positions, which is the number of
+/// literals in the regex.
+uint32_t GlushkovMatcher::getPositionCount() const
+{
+    return this->positionCount;
+}
+
+/// \brief Gets the number of distinct symbols in the regex.
+uint32_t GlushkovMatcher::getSymbolCount() const
+{
+    return this->symbols.getCount();
+}
+
+/// \brief Gets the table that assigns the regex's symbols their
+/// ids.
+const SymbolTable<std::string>& GlushkovMatcher::getSymbolTable() const
+{
+    return this->symbols;
+}
+
+/// \brief Gets the number of words in a set of positions.
+uint32_t GlushkovMatcher::getWordCount() const
+{
+    return this->wordCount;
+}
+
+/// \brief Checks if this matcher simulates the position automaton
+/// bit-parallelly, rather than with a lazy DFA, which is the
+/// case if the regex has at most MaxPositions literals.
+bool GlushkovMatcher::IsBitParallel() const
+{
+    return this->fallback == nullptr;
+}
+
+/// \brief Runs the simulation on the string of symbol ids that is
+/// produced by the given function.
+template<typename TSymbolFunction>
+bool GlushkovMatcher::Run(std::size_t Length, TSymbolFunction GetSymbol) const
+{
+    auto follow = this->followTable.data();
+    auto masks = this->symbolMasks.data();
+    if (this->wordCount == 1)
+    {
+        // Regexes with fewer than 64 literals keep the whole set of
+        // active positions in a single register.
+        uint64_t state = 1;
+        for (std::size_t i = 0; i < Length && state != 0; i++)
+        {
+            uint64_t next = 0;
+            for (uint32_t c = 0; c < this->chunkCount; c++)
+                next |= follow[c * 256 + (state >> (c * 8) & 0xFF)];
+            state = next & masks[GetSymbol(i)];
+        }
+        return (state & this->finalMask[0]) != 0;
+    }
+
+    std::vector<uint64_t> state(this->wordCount, 0);
+    std::vector<uint64_t> next(this->wordCount);
+    state[0] = 1;
+    bool isEmpty = false;
+    for (std::size_t i = 0; i < Length && !isEmpty; i++)
+    {
+        std::fill(next.begin(), next.end(), 0);
+        for (uint32_t c = 0; c < this->chunkCount; c++)
+        {
+            auto byte = state[c / 8] >> (c % 8 * 8) & 0xFF;
+            if (byte == 0)
+                continue;
+            auto entry = follow + ((std::size_t)c * 256 + byte) * this->wordCount;
+            for (uint32_t w = 0; w < this->wordCount; w++)
+                next[w] |= entry[w];
+        }
+        auto mask = masks + (std::size_t)GetSymbol(i) * this->wordCount;
+        isEmpty = true;
+        for (uint32_t w = 0; w < this->wordCount; w++)
+        {
+            state[w] = next[w] & mask[w];
+            isEmpty = isEmpty && state[w] == 0;
+        }
+    }
+    for (uint32_t w = 0; w < this->wordCount; w++)
+        if ((state[w] & this->finalMask[w]) != 0)
+            return true;
+
+    return false;
+}
+
+/// \brief Applies the given match function to the lazy DFA that
+/// is used instead of the bit-parallel simulation, or to a
+/// private one if another thread is using it.
+template<typename TMatchFunction>
+bool GlushkovMatcher::RunFallback(TMatchFunction Match) const
+{
+    std::unique_lock<std::mutex> lock(this->fallbackLock, std::try_to_lock);
+    if (lock.owns_lock())
+        return Match(*this->fallbackMatcher);
+    LazyDFA<std::string> dfa(this->fallback);
+    return Match(dfa);
+}
\ No newline at end of file
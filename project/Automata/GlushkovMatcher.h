@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ArraySlice.h"
+#include "CompiledNFA.h"
+#include "IAutomaton.h"
+#include "IRegex.h"
+#include "LazyDFA.h"
+#include "SymbolTable.h"
+
+namespace Automata
+{
+    /// \brief Defines a matcher that simulates a regex's Glushkov
+    /// (position) automaton bit-parallelly. Every literal in the regex
+    /// is a position, and bit zero stands for the initial state; see
+    /// PositionAutomaton. A set of active positions is a vector of
+    /// 64-bit words, which is a single word for regexes with fewer
+    /// than 64 literals. A step maps the active set to the union of
+    /// its positions' follow sets, by looking up every byte of the set
+    /// in a precomputed table, and then masks out the positions that
+    /// are not labeled with the current symbol.
+    /// The table takes about 4 * n * n bytes for n positions, and a
+    /// step takes about n * n / 512 word operations, so regexes with
+    /// more than MaxPositions literals are not simulated
+    /// bit-parallelly: their position automaton is matched by a lazy
+    /// DFA instead.
+    class GlushkovMatcher : public virtual IAutomaton<std::string>
+    {
+    public:
+        /// \brief The largest number of positions that is simulated
+        /// bit-parallelly, for which the follow table takes about
+        /// four megabytes.
+        static const uint32_t MaxPositions = 1024;
+
+        /// \brief Creates a matcher for the given regex, which must
+        /// consist of literal, concat, union, closure, epsilon and phi
+        /// regexes.
+        GlushkovMatcher(std::shared_ptr<IRegex> Regex);
+
+        /// \brief Figures out whether this matcher accepts the given
+        /// string of symbols.
+        bool Accepts(stdx::ArraySlice<std::string> Characters) const override;
+
+        /// \brief Figures out whether this matcher accepts the given
+        /// string of symbol ids.
+        bool Accepts(const uint32_t* Symbols, std::size_t Length) const;
+
+        /// \brief Figures out whether this matcher accepts the given
+        /// string of bytes.
+        bool Accepts(const char* Data, std::size_t Length) const;
+
+        /// \brief Gets the id of the given symbol. Symbols that do not
+        /// occur in the regex are mapped to getSymbolCount().
+        uint32_t GetSymbolId(const std::string& Symbol) const;
+
+        /// \brief Gets the number of positions, which is the number of
+        /// literals in the regex.
+        uint32_t getPositionCount() const;
+
+        /// \brief Gets the number of distinct symbols in the regex.
+        uint32_t getSymbolCount() const;
+
+        /// \brief Gets the table that assigns the regex's symbols their
+        /// ids.
+        const SymbolTable<std::string>& getSymbolTable() const;
+
+        /// \brief Gets the number of words in a set of positions.
+        uint32_t getWordCount() const;
+
+        /// \brief Checks if this matcher simulates the position automaton
+        /// bit-parallelly, rather than with a lazy DFA, which is the
+        /// case if the regex has at most MaxPositions literals.
+        bool IsBitParallel() const;
+    private:
+        /// \brief Runs the simulation on the string of symbol ids that is
+        /// produced by the given function.
+        template<typename TSymbolFunction>
+        bool Run(std::size_t Length, TSymbolFunction GetSymbol) const;
+
+        /// \brief Applies the given match function to the lazy DFA that
+        /// is used instead of the bit-parallel simulation, or to a
+        /// private one if another thread is using it.
+        template<typename TMatchFunction>
+        bool RunFallback(TMatchFunction Match) const;
+
+        SymbolTable<std::string> symbols;
+        uint32_t positionCount;
+        uint32_t wordCount;
+        uint32_t chunkCount;
+        std::vector<uint64_t> followTable;
+        std::vector<uint64_t> symbolMasks;
+        std::vector<uint64_t> finalMask;
+        std::shared_ptr<const CompiledNFA<std::string>> fallback;
+        std::unique_ptr<LazyDFA<std::string>> fallbackMatcher;
+        mutable std::mutex fallbackLock;
+    };
+}
\ No newline at end of file
@@ -2,7 +2,6 @@
 #include <utility>
 #include "LinearSet.h"
 #include "Optional.h"
-#include "RegexState.h"
 
 namespace std
 {
@@ -0,0 +1,55 @@
+#include "IRegex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "HashExtensions.h"
+#include "LinearSet.h"
+#include "NFAutomaton.h"
+#include "PositionAutomaton.h"
+#include "ThompsonBuilder.h"
+#include "TransitionTable.h"
+
+using namespace Automata;
+
+/// \brief Constructs an epsilon-nfa for this regex, by appending
+/// it to an empty Thompson builder.
+ENFAutomaton<uint32_t, std::string> IRegex::ToENFAutomaton() const
+{
+    ThompsonBuilder builder;
+    auto fragment = this->AppendENFAutomaton(builder);
+    return builder.ToENFAutomaton(fragment);
+}
+
+/// \brief Constructs this regex's position automaton: an nfa
+/// without epsilon transitions that has one state per literal,
+/// plus a start state. State p is position p, so the start
+/// state is state zero.
+NFAutomaton<uint32_t, std::string> IRegex::ToNFAutomaton() const
+{
+    PositionAutomaton positions(this);
+    auto& symbols = positions.getSymbolTable();
+
+    LinearSet<uint32_t> accepting;
+    std::unordered_map<std::pair<uint32_t, std::string>, LinearSet<uint32_t>> transitions;
+    for (uint32_t p = 0; p <= positions.getPositionCount(); p++)
+    {
+        if (positions.IsFinal(p))
+            accepting.Add(p);
+
+        for (auto q : positions.GetFollow(p))
+            transitions[std::make_pair(p, symbols.GetSymbol(positions.GetLabel(q)))].Add(q);
+    }
+
+    return NFAutomaton<uint32_t, std::string>(0, accepting, TransitionTable<std::pair<uint32_t, std::string>, LinearSet<uint32_t>>(transitions));
+}
+
+/// \brief Combines the given hash code with another value's hash
+/// code.
+std::size_t IRegex::CombineHashes(std::size_t Seed, std::size_t Value)
+{
+    return Seed ^ (Value + 0x9E3779B9 + (Seed << 6) + (Seed >> 2));
+}
\ No newline at end of file
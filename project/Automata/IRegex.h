@@ -1,18 +1,54 @@
 #pragma once
-#include <memory>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include "ENFAutomaton.h"
-#include "RegexState.h"
+#include "NFAutomaton.h"
+#include "ThompsonBuilder.h"
 
 namespace Automata
 {
+    /// \brief Lists the kinds of regular expressions.
+    enum RegexKind
+    {
+        LiteralKind,
+        ConcatKind,
+        UnionKind,
+        ClosureKind,
+        EpsilonKind,
+        PhiKind
+    };
+
     /// \brief Defines a generic regular expression.
     struct IRegex
     {
-        /// \brief Constructs an epsilon-nfa for this regex.
-        virtual ENFAutomaton<std::shared_ptr<RegexState>, std::string> ToENFAutomaton() const = 0;
+        /// \brief Constructs an epsilon-nfa for this regex, by appending
+        /// it to an empty Thompson builder.
+        ENFAutomaton<uint32_t, std::string> ToENFAutomaton() const;
+
+        /// \brief Appends the states and transitions of this regex's
+        /// e-NFA to the given builder, and returns the resulting
+        /// fragment.
+        virtual RegexFragment AppendENFAutomaton(ThompsonBuilder& Builder) const = 0;
+
+        /// \brief Constructs this regex's position automaton: an nfa
+        /// without epsilon transitions that has one state per literal,
+        /// plus a start state. State p is position p, so the start
+        /// state is state zero.
+        NFAutomaton<uint32_t, std::string> ToNFAutomaton() const;
 
         /// \brief Gets this regex's string representation.
         virtual std::string ToString() const = 0;
+
+        /// \brief Gets this regex's hash code, which depends on its
+        /// structure only, and is computed when the regex is created.
+        virtual std::size_t getHashCode() const = 0;
+
+        /// \brief Gets this regex's kind.
+        virtual RegexKind getKind() const = 0;
+    protected:
+        /// \brief Combines the given hash code with another value's hash
+        /// code.
+        static std::size_t CombineHashes(std::size_t Seed, std::size_t Value);
     };
 }
\ No newline at end of file
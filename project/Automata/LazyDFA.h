@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "ArraySlice.h"
+#include "CompiledNFA.h"
+#include "IAutomaton.h"
+#include "SparseSet.h"
+#include "SubsetTable.h"
+
+namespace Automata
+{
+    /// \brief Defines a DFA that is constructed on the fly from a
+    /// compiled NFA, one state and one transition at a time, as the
+    /// input reaches them. Constructed states and transitions are
+    /// cached, and the cache is flushed whenever it outgrows its memory
+    /// budget, so matching never pays for the full subset
+    /// construction. The cache is mutated by const member functions:
+    /// a lazy DFA must not be shared between threads.
+    template<typename TChar>
+    class LazyDFA : public virtual IAutomaton<TChar>
+    {
+    public:
+        /// \brief The default cache budget, in bytes.
+        static const std::size_t DefaultCacheBudget = 8 << 20;
+
+        /// \brief Creates a lazy DFA for the given automaton, with the
+        /// default cache budget.
+        LazyDFA(std::shared_ptr<const CompiledNFA<TChar>> Automaton);
+
+        /// \brief Creates a lazy DFA for the given automaton, whose cache
+        /// may use approximately the given number of bytes.
+        LazyDFA(std::shared_ptr<const CompiledNFA<TChar>> Automaton, std::size_t CacheBudget);
+
+        /// \brief Figures out whether this automaton accepts the given
+        /// string of symbols.
+        bool Accepts(stdx::ArraySlice<TChar> Characters) const override;
+
+        /// \brief Figures out whether this automaton accepts the given
+        /// string of symbol ids.
+        bool Accepts(const uint32_t* Symbols, std::size_t Length) const;
+
+        /// \brief Figures out whether this automaton accepts the given
+        /// string of bytes.
+        bool Accepts(const char* Data, std::size_t Length) const;
+
+        /// \brief Discards all cached states and transitions.
+        void Flush() const;
+
+        /// \brief Gets the automaton that this lazy DFA simulates.
+        std::shared_ptr<const CompiledNFA<TChar>> getAutomaton() const;
+
+        /// \brief Gets the approximate number of bytes that the cache may
+        /// use before it is flushed.
+        std::size_t getCacheBudget() const;
+
+        /// \brief Gets the number of DFA states that are currently cached.
+        uint32_t getCachedStateCount() const;
+
+        /// \brief Gets the number of times the cache has been flushed
+        /// because it exceeded its budget.
+        std::size_t getFlushCount() const;
+    private:
+        /// \brief Marks a transition that has not been computed yet.
+        static const uint32_t UnknownState = 0xFFFFFFFF;
+
+        /// \brief Adds the given sorted set of NFA states to the cache,
+        /// if it is not cached yet, and returns its DFA state id.
+        uint32_t AddState(const std::vector<uint32_t>& States) const;
+
+        /// \brief Gets the approximate number of bytes used by the cache.
+        std::size_t GetCacheSize() const;
+
+        /// \brief Computes and caches the transition from the given state
+        /// on the given symbol id, and returns its target. If the cache
+        /// is flushed in the process, the source state is re-added and
+        /// its new id is stored in State.
+        uint32_t ComputeTransition(uint32_t& State, uint32_t Symbol) const;
+
+        /// \brief Performs the extended transition from the start state
+        /// on the given string of symbol ids, which are produced by the
+        /// given function, and checks if the final state is accepting.
+        template<typename TSymbolFunction>
+        bool Run(std::size_t Length, TSymbolFunction GetSymbol) const;
+
+        std::shared_ptr<const CompiledNFA<TChar>> automaton;
+        std::size_t cacheBudget;
+        uint32_t rowLength;
+        mutable SubsetTable states;
+        mutable std::vector<uint32_t> transitions;
+        mutable std::vector<bool> accepting;
+        mutable uint32_t startState;
+        mutable std::size_t flushCount;
+        mutable SparseSet current;
+        mutable SparseSet successors;
+    };
+}
+
+#include "LazyDFA.hxx"
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "LazyDFA.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "ArraySlice.h"
+#include "CompiledNFA.h"
+#include "IAutomaton.h"
+#include "SparseSet.h"
+#include "SubsetTable.h"
+
+using namespace Automata;
+
+template<typename TChar>
+const std::size_t LazyDFA<TChar>::DefaultCacheBudget;
+
+template<typename TChar>
+const uint32_t LazyDFA<TChar>::UnknownState;
+
+/// \brief Creates a lazy DFA for the given automaton, with the
+/// default cache budget.
+template<typename TChar>
+LazyDFA<TChar>::LazyDFA(std::shared_ptr<const CompiledNFA<TChar>> Automaton)
+    : LazyDFA(Automaton, DefaultCacheBudget)
+{ }
+
+/// \brief Creates a lazy DFA for the given automaton, whose cache
+/// may use approximately the given number of bytes.
+template<typename TChar>
+LazyDFA<TChar>::LazyDFA(std::shared_ptr<const CompiledNFA<TChar>> Automaton, std::size_t CacheBudget)
+    : automaton(Automaton), cacheBudget(CacheBudget), rowLength(Automaton->getSymbolCount() + 1),
+      flushCount(0), current(Automaton->getStateCount()), successors(Automaton->getStateCount())
+{
+    this->Flush();
+}
+
+/// \brief Figures out whether this automaton accepts the given
+/// string of symbols.
+template<typename TChar>
+bool LazyDFA<TChar>::Accepts(stdx::ArraySlice<TChar> Characters) const
+{
+    auto symbols = this->automaton->TranslateSymbols(Characters);
+    return this->Accepts(symbols.data(), symbols.size());
+}
+
+/// \brief Figures out whether this automaton accepts the given
+/// string of symbol ids.
+template<typename TChar>
+bool LazyDFA<TChar>::Accepts(const uint32_t* Symbols, std::size_t Length) const
+{
+    return this->Run(Length, [=](std::size_t Index) { return Symbols[Index]; });
+}
+
+/// \brief Figures out whether this automaton accepts the given
+/// string of bytes.
+template<typename TChar>
+bool LazyDFA<TChar>::Accepts(const char* Data, std::size_t Length) const
+{
+    auto nfa = this->automaton.get();
+    return this->Run(Length, [=](std::size_t Index) { return nfa->GetByteSymbolId((unsigned char)Data[Index]); });
+}
+
+/// \brief Discards all cached states and transitions.
+template<typename TChar>
+void LazyDFA<TChar>::Flush() const
+{
+    this->states.Clear();
+    this->transitions.clear();
+    this->accepting.clear();
+    // The empty set is always state zero, and it is its own successor
+    // on every symbol.
+    this->AddState(std::vector<uint32_t>());
+    std::fill(this->transitions.begin(), this->transitions.end(), 0);
+
+    this->current.Clear();
+    this->current.Add(this->automaton->getStartState());
+    this->automaton->Eclose(this->current);
+    std::vector<uint32_t> start(this->current.getItems());
+    std::sort(start.begin(), start.end());
+    this->startState = this->AddState(start);
+}
+
+/// \brief Gets the automaton that this lazy DFA simulates.
+template<typename TChar>
+std::shared_ptr<const CompiledNFA<TChar>> LazyDFA<TChar>::getAutomaton() const
+{
+    return this->automaton;
+}
+
+/// \brief Gets the approximate number of bytes that the cache may
+/// use before it is flushed.
+template<typename TChar>
+std::size_t LazyDFA<TChar>::getCacheBudget() const
+{
+    return this->cacheBudget;
+}
+
+/// \brief Gets the number of DFA states that are currently cached.
+template<typename TChar>
+uint32_t LazyDFA<TChar>::getCachedStateCount() const
+{
+    return this->states.getCount();
+}
+
+/// \brief Gets the number of times the cache has been flushed
+/// because it exceeded its budget.
+template<typename TChar>
+std::size_t LazyDFA<TChar>::getFlushCount() const
+{
+    return this->flushCount;
+}
+
+/// \brief Adds the given sorted set of NFA states to the cache,
+/// if it is not cached yet, and returns its DFA state id.
+template<typename TChar>
+uint32_t LazyDFA<TChar>::AddState(const std::vector<uint32_t>& States) const
+{
+    bool added;
+    auto id = this->states.Add(States.data(), States.size(), added);
+    if (added)
+    {
+        bool isAccepting = false;
+        for (auto q : States)
+            isAccepting = isAccepting || this->automaton->IsAcceptingState(q);
+        this->accepting.push_back(isAccepting);
+        this->transitions.resize(this->transitions.size() + this->rowLength, UnknownState);
+    }
+    return id;
+}
+
+/// \brief Gets the approximate number of bytes used by the cache.
+template<typename TChar>
+std::size_t LazyDFA<TChar>::GetCacheSize() const
+{
+    // Every state costs a row of transitions, its items, and a few
+    // words of bookkeeping in the subset table.
+    return this->transitions.size() * sizeof(uint32_t)
+         + this->states.getItemCount() * sizeof(uint32_t)
+         + (std::size_t)this->states.getCount() * (sizeof(std::size_t) + sizeof(uint64_t) + 2 * sizeof(uint32_t));
+}
+
+/// \brief Computes and caches the transition from the given state
+/// on the given symbol id, and returns its target. If the cache
+/// is flushed in the process, the source state is re-added and
+/// its new id is stored in State.
+template<typename TChar>
+uint32_t LazyDFA<TChar>::ComputeTransition(uint32_t& State, uint32_t Symbol) const
+{
+    this->current.Clear();
+    auto items = this->states.GetItems(State);
+    for (uint32_t i = 0; i < this->states.GetSize(State); i++)
+        this->current.Add(items[i]);
+    this->successors.Clear();
+    this->automaton->PerformAllTransitions(this->current, Symbol, this->successors);
+    this->automaton->Eclose(this->successors);
+    std::vector<uint32_t> target(this->successors.getItems());
+    std::sort(target.begin(), target.end());
+
+    if (this->states.Find(target.data(), target.size()) == SubsetTable::NoSubset
+        && this->GetCacheSize() + (this->rowLength + target.size()) * sizeof(uint32_t) > this->cacheBudget)
+    {
+        // Start over with an empty cache, but keep the source state
+        // around: the caller is still matching from it.
+        std::vector<uint32_t> source(items, items + this->states.GetSize(State));
+        this->Flush();
+        this->flushCount++;
+        State = this->AddState(source);
+    }
+    auto result = this->AddState(target);
+    this->transitions[(std::size_t)State * this->rowLength + Symbol] = result;
+    return result;
+}
+
+/// \brief Performs the extended transition from the start state
+/// on the given string of symbol ids, which are produced by the
+/// given function, and checks if the final state is accepting.
+template<typename TChar>
+template<typename TSymbolFunction>
+bool LazyDFA<TChar>::Run(std::size_t Length, TSymbolFunction GetSymbol) const
+{
+    auto state = this->startState;
+    for (std::size_t i = 0; i < Length && state != 0; i++)
+    {
+        auto symbol = GetSymbol(i);
+        auto next = this->transitions[(std::size_t)state * this->rowLength + symbol];
+        if (next == UnknownState)
+            next = this->ComputeTransition(state, symbol);
+        state = next;
+    }
+    return this->accepting[state];
+}
\ No newline at end of file
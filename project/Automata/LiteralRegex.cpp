@@ -1,44 +1,46 @@
 #include "LiteralRegex.h"
 
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <string>
-#include <unordered_map>
-#include <utility>
-#include "ENFAutomaton.h"
 #include "IRegex.h"
-#include "LinearSet.h"
-#include "Optional.h"
-#include "RegexState.h"
-#include "TransitionTable.h"
+#include "ThompsonBuilder.h"
 
 using namespace Automata;
 
 /// \brief Creates a literal regex for the given symbol.
 LiteralRegex::LiteralRegex(std::string Literal)
-    : Literal(Literal)
+    : Literal(Literal), hashCode(CombineHashes(LiteralKind, std::hash<std::string>()(Literal)))
 { }
 
-/// \brief Constructs an epsilon-nfa for this regex.
+/// \brief Appends this regex's e-NFA to the given builder.
 /// The construction is as follows:    start literal end.
-/// where 'start' is the initial state, 'end' is an accepting
-/// state, and 'literal' is this regex' literal.
-ENFAutomaton<std::shared_ptr<RegexState>, std::string> LiteralRegex::ToENFAutomaton() const
+/// where 'start' is the fragment's start state, 'end' is its
+/// accepting state, and 'literal' is this regex' literal.
+RegexFragment LiteralRegex::AppendENFAutomaton(ThompsonBuilder& Builder) const
 {
-    auto startState = std::make_shared<RegexState>();
-    LinearSet<std::shared_ptr<RegexState>> acceptingStates;
-    acceptingStates.Add(std::make_shared<RegexState>());
-    std::unordered_map<std::pair<std::shared_ptr<RegexState>, Optional<std::string>>, LinearSet<std::shared_ptr<RegexState>>> transitions;
-    std::pair<std::shared_ptr<RegexState>, Optional<std::string>> label(startState, 
-                                                                        Optional<std::string>(this->Literal));
-    transitions[label] = acceptingStates;
-    TransitionTable<std::pair<std::shared_ptr<RegexState>, Optional<std::string>>, LinearSet<std::shared_ptr<RegexState>>> transTable(transitions);
-    return ENFAutomaton<std::shared_ptr<RegexState>, std::string>(startState, 
-                                                                  acceptingStates, 
-                                                                  transTable);
+    auto startState = Builder.CreateState();
+    auto endState = Builder.CreateState();
+    Builder.AddTransition(startState, this->Literal, endState);
+    return RegexFragment(startState, endState);
 }
 
 /// \brief Gets this regex's string representation.
 std::string LiteralRegex::ToString() const
 {
     return this->Literal;
+}
+
+/// \brief Gets this regex's hash code, which depends on its
+/// structure only, and is computed when the regex is created.
+std::size_t LiteralRegex::getHashCode() const
+{
+    return this->hashCode;
+}
+
+/// \brief Gets this regex's kind.
+RegexKind LiteralRegex::getKind() const
+{
+    return LiteralKind;
 }
\ No newline at end of file
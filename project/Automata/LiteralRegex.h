@@ -1,9 +1,10 @@
 #pragma once
+#include <cstddef>
 #include <memory>
 #include <string>
 #include "ENFAutomaton.h"
 #include "IRegex.h"
-#include "RegexState.h"
+#include "ThompsonBuilder.h"
 
 namespace Automata
 {
@@ -14,16 +15,25 @@ namespace Automata
         /// \brief Creates a literal regex for the given symbol.
         LiteralRegex(std::string Literal);
 
-        /// \brief Constructs an epsilon-nfa for this regex.
+        /// \brief Appends this regex's e-NFA to the given builder.
         /// The construction is as follows:    start literal end.
-        /// where 'start' is the initial state, 'end' is an accepting
-        /// state, and 'literal' is this regex' literal.
-        ENFAutomaton<std::shared_ptr<RegexState>, std::string> ToENFAutomaton() const override;
+        /// where 'start' is the fragment's start state, 'end' is its
+        /// accepting state, and 'literal' is this regex' literal.
+        RegexFragment AppendENFAutomaton(ThompsonBuilder& Builder) const override;
 
         /// \brief Gets this regex's string representation.
         std::string ToString() const override;
 
+        /// \brief Gets this regex's hash code, which depends on its
+        /// structure only, and is computed when the regex is created.
+        std::size_t getHashCode() const override;
+
+        /// \brief Gets this regex's kind.
+        RegexKind getKind() const override;
+
         /// \brief Gets the literal regex's literal or symbol.
         std::string Literal;
+    private:
+        std::size_t hashCode;
     };
 }
\ No newline at end of file
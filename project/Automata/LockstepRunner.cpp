@@ -0,0 +1,238 @@
+#include "LockstepRunner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AUTOMATA_AVX2
+#define AUTOMATA_AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define AUTOMATA_AVX2
+#define AUTOMATA_AVX2_TARGET
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+using namespace Automata;
+
+const std::size_t LockstepRunner::LaneCount;
+
+/// \brief Creates a runner for the DFA with the given row-major
+/// transition table, row length, byte-to-column table and start
+/// state.
+LockstepRunner::LockstepRunner(const uint32_t* Transitions, uint32_t StateCount, uint32_t RowLength, const uint32_t* ByteColumns, uint32_t StartState)
+    : transitions(Transitions), rowLength(RowLength), byteColumns(ByteColumns), startState(StartState),
+      usesGather(false)
+{
+    // Gathers take signed 32-bit indices.
+    if (IsGatherSupported() && (uint64_t)StateCount * RowLength <= 0x7FFFFFFF)
+        this->usesGather = this->IsGatherFaster();
+}
+
+/// \brief Runs the DFA over the given strings: string i is the
+/// range [Starts[i], Ends[i]) of the given buffer. The state the
+/// DFA ends up in for string i is stored in States[i].
+void LockstepRunner::Run(const char* Data, const std::size_t* Starts, const std::size_t* Ends, std::size_t Count, uint32_t* States) const
+{
+    if (this->usesGather)
+        this->RunGather(Data, Starts, Ends, Count, States);
+    else
+        this->RunInterleaved(Data, Starts, Ends, Count, States);
+}
+
+/// \brief Runs the DFA over the given strings with the portable,
+/// interleaved scalar kernel.
+void LockstepRunner::RunInterleaved(const char* Data, const std::size_t* Starts, const std::size_t* Ends, std::size_t Count, uint32_t* States) const
+{
+    auto data = (const unsigned char*)Data;
+    auto table = this->transitions;
+    auto columns = this->byteColumns;
+    auto rowLength = this->rowLength;
+    std::size_t first = 0;
+    for (; first + LaneCount <= Count; first += LaneCount)
+    {
+        auto steps = this->GetSharedLength(Starts + first, Ends + first);
+
+        // The lanes are spelled out, so that their states stay in
+        // registers.
+        auto p0 = data + Starts[first];
+        auto p1 = data + Starts[first + 1];
+        auto p2 = data + Starts[first + 2];
+        auto p3 = data + Starts[first + 3];
+        auto p4 = data + Starts[first + 4];
+        auto p5 = data + Starts[first + 5];
+        auto p6 = data + Starts[first + 6];
+        auto p7 = data + Starts[first + 7];
+        auto q0 = this->startState, q1 = q0, q2 = q0, q3 = q0, q4 = q0, q5 = q0, q6 = q0, q7 = q0;
+        for (std::size_t i = 0; i < steps; i++)
+        {
+            q0 = table[(std::size_t)q0 * rowLength + columns[p0[i]]];
+            q1 = table[(std::size_t)q1 * rowLength + columns[p1[i]]];
+            q2 = table[(std::size_t)q2 * rowLength + columns[p2[i]]];
+            q3 = table[(std::size_t)q3 * rowLength + columns[p3[i]]];
+            q4 = table[(std::size_t)q4 * rowLength + columns[p4[i]]];
+            q5 = table[(std::size_t)q5 * rowLength + columns[p5[i]]];
+            q6 = table[(std::size_t)q6 * rowLength + columns[p6[i]]];
+            q7 = table[(std::size_t)q7 * rowLength + columns[p7[i]]];
+        }
+        uint32_t states[LaneCount] = { q0, q1, q2, q3, q4, q5, q6, q7 };
+        this->FinishGroup(data, Starts + first, Ends + first, steps, states, States + first);
+    }
+    for (; first < Count; first++)
+        States[first] = this->RunSingle(this->startState, data + Starts[first], data + Ends[first]);
+}
+
+#ifdef AUTOMATA_AVX2
+/// \brief Runs the DFA over the given strings with the AVX2
+/// kernel, which must be supported.
+AUTOMATA_AVX2_TARGET
+void LockstepRunner::RunGather(const char* Data, const std::size_t* Starts, const std::size_t* Ends, std::size_t Count, uint32_t* States) const
+{
+    auto data = (const unsigned char*)Data;
+    auto table = (const int*)this->transitions;
+    auto columns = (const int*)this->byteColumns;
+    auto rows = _mm256_set1_epi32((int)this->rowLength);
+    std::size_t first = 0;
+    for (; first + LaneCount <= Count; first += LaneCount)
+    {
+        auto steps = this->GetSharedLength(Starts + first, Ends + first);
+        const unsigned char* p[LaneCount];
+        for (std::size_t l = 0; l < LaneCount; l++)
+            p[l] = data + Starts[first + l];
+
+        // The bytes are loaded one lane at a time; their columns and
+        // the transitions of all lanes are gathered at once.
+        auto states = _mm256_set1_epi32((int)this->startState);
+        for (std::size_t i = 0; i < steps; i++)
+        {
+            auto bytes = _mm256_setr_epi32(p[0][i], p[1][i], p[2][i], p[3][i], p[4][i], p[5][i], p[6][i], p[7][i]);
+            auto offsets = _mm256_add_epi32(_mm256_mullo_epi32(states, rows), _mm256_i32gather_epi32(columns, bytes, 4));
+            states = _mm256_i32gather_epi32(table, offsets, 4);
+        }
+        uint32_t lanes[LaneCount];
+        _mm256_storeu_si256((__m256i*)lanes, states);
+        this->FinishGroup(data, Starts + first, Ends + first, steps, lanes, States + first);
+    }
+    for (; first < Count; first++)
+        States[first] = this->RunSingle(this->startState, data + Starts[first], data + Ends[first]);
+}
+#else
+/// \brief Runs the DFA over the given strings with the AVX2
+/// kernel, which must be supported.
+void LockstepRunner::RunGather(const char* Data, const std::size_t* Starts, const std::size_t* Ends, std::size_t Count, uint32_t* States) const
+{
+    this->RunInterleaved(Data, Starts, Ends, Count, States);
+}
+#endif
+
+/// \brief Runs the remainders of a group of strings, which have
+/// already been run in lockstep for the given number of bytes,
+/// one string at a time.
+void LockstepRunner::FinishGroup(const unsigned char* Data, const std::size_t* Starts, const std::size_t* Ends, std::size_t Steps, const uint32_t* Lanes, uint32_t* States) const
+{
+    for (std::size_t l = 0; l < LaneCount; l++)
+        States[l] = this->RunSingle(Lanes[l], Data + Starts[l] + Steps, Data + Ends[l]);
+}
+
+/// \brief Gets the length of the shortest string in a group,
+/// which is the number of bytes that all of its lanes can take
+/// in lockstep.
+std::size_t LockstepRunner::GetSharedLength(const std::size_t* Starts, const std::size_t* Ends)
+{
+    auto result = Ends[0] - Starts[0];
+    for (std::size_t l = 1; l < LaneCount; l++)
+        result = std::min(result, Ends[l] - Starts[l]);
+    return result;
+}
+
+/// \brief Checks if the AVX2 kernel is compiled in, and supported
+/// by the processor and operating system.
+bool LockstepRunner::IsGatherSupported()
+{
+#if defined(AUTOMATA_AVX2) && defined(__GNUC__)
+    return __builtin_cpu_supports("avx2") != 0;
+#elif defined(AUTOMATA_AVX2)
+    // AVX2 needs processor support, and an operating system that
+    // saves the YMM registers.
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0)
+        return false;
+    if ((_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+/// \brief Times both kernels on a small batch of strings made up
+/// of bytes in the automaton's alphabet, and checks if the AVX2
+/// kernel is faster. Gathers are slower than scalar loads on some
+/// processors that support them.
+bool LockstepRunner::IsGatherFaster() const
+{
+    std::vector<unsigned char> alphabet;
+    for (unsigned b = 0; b < 256; b++)
+        if (this->byteColumns[b] != this->rowLength - 1)
+            alphabet.push_back((unsigned char)b);
+    if (alphabet.empty())
+        return false;
+
+    const std::size_t count = 256;
+    const std::size_t length = 32;
+    std::vector<char> data(count * length);
+    uint32_t seed = 1;
+    for (auto& byte : data)
+    {
+        seed = seed * 1103515245 + 12345;
+        byte = (char)alphabet[(seed >> 16) % alphabet.size()];
+    }
+    std::vector<std::size_t> starts(count);
+    std::vector<std::size_t> ends(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        starts[i] = i * length;
+        ends[i] = starts[i] + length;
+    }
+    std::vector<uint32_t> states(count);
+
+    // The best of a few runs is taken, to filter out noise. Ties,
+    // which a coarse clock produces, go to the scalar kernel.
+    auto interleaved = std::chrono::high_resolution_clock::duration::max();
+    auto gather = interleaved;
+    for (int i = 0; i < 3; i++)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        this->RunInterleaved(data.data(), starts.data(), ends.data(), count, states.data());
+        auto middle = std::chrono::high_resolution_clock::now();
+        this->RunGather(data.data(), starts.data(), ends.data(), count, states.data());
+        auto end = std::chrono::high_resolution_clock::now();
+        interleaved = std::min(interleaved, middle - start);
+        gather = std::min(gather, end - middle);
+    }
+    return gather < interleaved;
+}
+
+/// \brief Checks if this runner uses the AVX2 kernel.
+bool LockstepRunner::getUsesGather() const
+{
+    return this->usesGather;
+}
+
+/// \brief Runs the DFA over a single string, starting in the
+/// given state.
+uint32_t LockstepRunner::RunSingle(uint32_t State, const unsigned char* Data, const unsigned char* End) const
+{
+    for (; Data != End; Data++)
+        State = this->transitions[(std::size_t)State * this->rowLength + this->byteColumns[*Data]];
+    return State;
+}
\ No newline at end of file
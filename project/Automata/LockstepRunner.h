@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace Automata
+{
+    /// \brief Defines a kernel that runs a compiled DFA over many
+    /// independent byte strings at once. A single DFA run is bound by
+    /// load latency, because every transition depends on the previous
+    /// one; advancing several strings in lockstep keeps several
+    /// independent loads in flight. Strings are taken in groups of
+    /// LaneCount consecutive strings, which are advanced in lockstep
+    /// for as many bytes as the shortest of them has, and whose
+    /// remainders are then run one at a time. Short-circuiting a lane
+    /// as soon as its string ends costs more than it saves for the
+    /// short strings this is meant for.
+    /// There are two versions of the kernel: a portable one that
+    /// interleaves scalar transitions, and one that performs the
+    /// transitions of all lanes with AVX2 gather instructions. The
+    /// AVX2 version is used if the processor supports it, and if it
+    /// turns out to be faster when the runner is created.
+    /// A runner does not own the tables it runs on.
+    class LockstepRunner
+    {
+    public:
+        /// \brief The number of strings that are advanced in lockstep,
+        /// which matches the width of an AVX2 register of state ids.
+        /// The scalar kernel spells its lanes out.
+        static const std::size_t LaneCount = 8;
+
+        /// \brief Creates a runner for the DFA with the given row-major
+        /// transition table, row length, byte-to-column table and start
+        /// state.
+        LockstepRunner(const uint32_t* Transitions, uint32_t StateCount, uint32_t RowLength, const uint32_t* ByteColumns, uint32_t StartState);
+
+        /// \brief Runs the DFA over the given strings: string i is the
+        /// range [Starts[i], Ends[i]) of the given buffer. The state the
+        /// DFA ends up in for string i is stored in States[i].
+        void Run(const char* Data, const std::size_t* Starts, const std::size_t* Ends, std::size_t Count, uint32_t* States) const;
+
+        /// \brief Runs the DFA over the given strings with the AVX2
+        /// kernel, which must be supported.
+        void RunGather(const char* Data, const std::size_t* Starts, const std::size_t* Ends, std::size_t Count, uint32_t* States) const;
+
+        /// \brief Runs the DFA over the given strings with the portable,
+        /// interleaved scalar kernel.
+        void RunInterleaved(const char* Data, const std::size_t* Starts, const std::size_t* Ends, std::size_t Count, uint32_t* States) const;
+
+        /// \brief Checks if the AVX2 kernel is compiled in, and supported
+        /// by the processor and operating system.
+        static bool IsGatherSupported();
+
+        /// \brief Checks if this runner uses the AVX2 kernel.
+        bool getUsesGather() const;
+    private:
+        /// \brief Runs the remainders of a group of strings, which have
+        /// already been run in lockstep for the given number of bytes,
+        /// one string at a time.
+        void FinishGroup(const unsigned char* Data, const std::size_t* Starts, const std::size_t* Ends, std::size_t Steps, const uint32_t* Lanes, uint32_t* States) const;
+
+        /// \brief Gets the length of the shortest string in a group,
+        /// which is the number of bytes that all of its lanes can take
+        /// in lockstep.
+        static std::size_t GetSharedLength(const std::size_t* Starts, const std::size_t* Ends);
+
+        /// \brief Times both kernels on a small batch of strings, and
+        /// checks if the AVX2 kernel is faster.
+        bool IsGatherFaster() const;
+
+        /// \brief Runs the DFA over a single string, starting in the
+        /// given state.
+        uint32_t RunSingle(uint32_t State, const unsigned char* Data, const unsigned char* End) const;
+
+        const uint32_t* transitions;
+        uint32_t rowLength;
+        const uint32_t* byteColumns;
+        uint32_t startState;
+        bool usesGather;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace Automata;
+
+#ifdef _WIN32
+/// \brief Maps the file at the given path into memory. Throws an
+/// exception if the file cannot be opened or mapped.
+MappedFile::MappedFile(const std::string& Path)
+    : data(nullptr), size(0), fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr)
+{
+    this->fileHandle = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER fileSize;
+    if (this->fileHandle == INVALID_HANDLE_VALUE || !GetFileSizeEx(this->fileHandle, &fileSize))
+    {
+        this->Close();
+        throw std::invalid_argument("File '" + Path + "' could not be opened.");
+    }
+    this->size = (std::size_t)fileSize.QuadPart;
+    if (this->size == 0)
+        return;
+
+    this->mappingHandle = CreateFileMappingA(this->fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (this->mappingHandle != nullptr)
+        this->data = (const char*)MapViewOfFile(this->mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (this->data == nullptr)
+    {
+        this->Close();
+        throw std::invalid_argument("File '" + Path + "' could not be mapped.");
+    }
+}
+
+/// \brief Unmaps the file.
+MappedFile::~MappedFile()
+{
+    this->Close();
+}
+
+/// \brief Unmaps the file, and closes the handles that refer to it.
+void MappedFile::Close()
+{
+    if (this->data != nullptr)
+        UnmapViewOfFile(this->data);
+    if (this->mappingHandle != nullptr)
+        CloseHandle(this->mappingHandle);
+    if (this->fileHandle != INVALID_HANDLE_VALUE)
+        CloseHandle(this->fileHandle);
+    this->data = nullptr;
+    this->mappingHandle = nullptr;
+    this->fileHandle = INVALID_HANDLE_VALUE;
+}
+#else
+/// \brief Maps the file at the given path into memory. Throws an
+/// exception if the file cannot be opened or mapped.
+MappedFile::MappedFile(const std::string& Path)
+    : data(nullptr), size(0)
+{
+    int descriptor = open(Path.c_str(), O_RDONLY);
+    struct stat status;
+    if (descriptor < 0 || fstat(descriptor, &status) != 0)
+    {
+        if (descriptor >= 0)
+            close(descriptor);
+        throw std::invalid_argument("File '" + Path + "' could not be opened.");
+    }
+    this->size = (std::size_t)status.st_size;
+    if (this->size > 0)
+    {
+        auto mapping = mmap(nullptr, this->size, PROT_READ, MAP_SHARED, descriptor, 0);
+        if (mapping != MAP_FAILED)
+            this->data = (const char*)mapping;
+    }
+    // The mapping stays valid after the file is closed.
+    close(descriptor);
+    if (this->size > 0 && this->data == nullptr)
+        throw std::invalid_argument("File '" + Path + "' could not be mapped.");
+}
+
+/// \brief Unmaps the file.
+MappedFile::~MappedFile()
+{
+    if (this->data != nullptr)
+        munmap((void*)this->data, this->size);
+}
+#endif
+
+/// \brief Gets the first byte of the mapped file, or null if the
+/// file is empty. The mapping is aligned to a page boundary.
+const char* MappedFile::getData() const
+{
+    return this->data;
+}
+
+/// \brief Gets the size of the mapped file, in bytes.
+std::size_t MappedFile::getSize() const
+{
+    return this->size;
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace Automata
+{
+    /// \brief Defines a read-only mapping of a whole file into memory.
+    /// The file's pages are loaded on demand, and are shared with every
+    /// other process that maps the same file.
+    class MappedFile
+    {
+    public:
+        /// \brief Maps the file at the given path into memory. Throws an
+        /// exception if the file cannot be opened or mapped.
+        MappedFile(const std::string& Path);
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /// \brief Unmaps the file.
+        ~MappedFile();
+
+        /// \brief Gets the first byte of the mapped file, or null if the
+        /// file is empty. The mapping is aligned to a page boundary.
+        const char* getData() const;
+
+        /// \brief Gets the size of the mapped file, in bytes.
+        std::size_t getSize() const;
+    private:
+#ifdef _WIN32
+        /// \brief Unmaps the file, and closes the handles that refer to it.
+        void Close();
+
+#endif
+        const char* data;
+        std::size_t size;
+#ifdef _WIN32
+        void* fileHandle;
+        void* mappingHandle;
+#endif
+    };
+}
\ No newline at end of file
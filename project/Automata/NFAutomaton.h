@@ -1,9 +1,17 @@
 #pragma once
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 #include "ArraySlice.h"
+#include "CompiledNFA.h"
 #include "DFAutomaton.h"
 #include "IAutomaton.h"
+#include "IFunction.h"
+#include "LazyDFA.h"
 #include "LinearSet.h"
+#include "SymbolTable.h"
 #include "TransitionTable.h"
 
 namespace Automata
@@ -22,6 +30,22 @@ namespace Automata
         /// string of symbols.
         bool Accepts(stdx::ArraySlice<TChar> Characters) const override;
 
+        /// \brief Compiles this automaton to integer state and symbol ids,
+        /// with its edges in compressed sparse row form. The start
+        /// state is assigned id zero.
+        CompiledNFA<TChar> Compile() const;
+
+        /// \brief Compiles this automaton to integer state and symbol ids,
+        /// and stores the original state that corresponds to each
+        /// state id in the given vector.
+        CompiledNFA<TChar> Compile(std::vector<TState>& States) const;
+
+        /// \brief Compiles this automaton, numbering its symbols with the
+        /// given symbol table, which is extended with any symbols it
+        /// does not contain yet. The original state that corresponds to
+        /// each state id is stored in the given vector.
+        CompiledNFA<TChar> Compile(const SymbolTable<TChar>& Symbols, std::vector<TState>& States) const;
+
         /// \brief Finds out whether the given sequence of states has a
         /// non-empty intersection with the set of accepting states.
         bool ContainsAcceptingState(LinearSet<TState> States) const;
@@ -39,7 +63,7 @@ namespace Automata
         LinearSet<TState> GetStates() const;
 
         /// \brief Gets this automaton's transition function.
-        TransitionTable<std::pair<TState, TChar>, LinearSet<TState>> getTransitionFunction() const;
+        const TransitionTable<std::pair<TState, TChar>, LinearSet<TState>>& getTransitionFunction() const;
 
         /// \brief Returns the set of all states reachable by performing a
         /// single transition with the given character for each state
@@ -54,9 +78,51 @@ namespace Automata
         /// state and symbol.
         LinearSet<TState> PerformTransition(TState State, TChar Character) const;
 
+        /// \brief Creates a new NFA by renaming this NFA's states and
+        /// symbols.
+        template<typename TNState, typename TNChar>
+        NFAutomaton<TNState, TNChar> Rename(const IFunction<TState, TNState>* StateRenamer, const IFunction<TChar, TNChar>* CharRenamer) const
+        {
+            auto newStart = StateRenamer->Apply(this->getStartState());
+            LinearSet<TNState> newAccept;
+            auto oldAccept = this->getAcceptingStates();
+            for (auto& val : oldAccept.getItems())
+                newAccept.Add(StateRenamer->Apply(val));
+            auto& currentTransFun = this->getTransitionFunction();
+            std::unordered_map<std::pair<TNState, TNChar>, LinearSet<TNState>> newTransMap;
+            for (auto& item : currentTransFun.getMap())
+            {
+                auto renamedOriginState = StateRenamer->Apply(item.first.first);
+                LinearSet<TNState> renamedTargetStates;
+                for (auto& state : item.second.getItems())
+                    renamedTargetStates.Add(StateRenamer->Apply(state));
+                newTransMap[std::pair<TNState, TNChar>(renamedOriginState, CharRenamer->Apply(item.first.second))] = renamedTargetStates;
+            }
+            TransitionTable<std::pair<TNState, TNChar>, LinearSet<TNState>> transFun(newTransMap);
+            return NFAutomaton<TNState, TNChar>(newStart, newAccept, transFun);
+        }
+
         /// \brief Performs the subset construction on this automaton.
         DFAutomaton<LinearSet<TState>, TChar> ToDFAutomaton() const;
     private:
+        /// \brief Holds an automaton's compiled form, along with the state
+        /// that corresponds to each state id, and a lazy DFA that caches
+        /// the subsets that Accepts visits. The compiled form is created
+        /// exactly once, even if several threads ask for it at the same
+        /// time; the lazy DFA is only used by one thread at a time.
+        struct CompiledForm
+        {
+            std::once_flag Compiled;
+            std::shared_ptr<const CompiledNFA<TChar>> Automaton;
+            std::vector<TState> States;
+            std::mutex MatcherLock;
+            std::unique_ptr<LazyDFA<TChar>> Matcher;
+        };
+
+        /// \brief Gets this automaton's compiled form, which is created on
+        /// first use and shared by all copies of this automaton.
+        CompiledForm& GetCompiledForm() const;
+
         /// \brief Sets this automaton's set of accepting states.
         void setAcceptingStates(LinearSet<TState> value);
 
@@ -66,13 +132,10 @@ namespace Automata
         /// \brief Sets this automaton's transition function.
         void setTransitionFunction(TransitionTable<std::pair<TState, TChar>, LinearSet<TState>> value);
 
-        /// \brief Performs the subset construction based on the given
-        /// alphabet.
-        DFAutomaton<LinearSet<TState>, TChar> ToDFAutomaton(LinearSet<TChar> Alphabet) const;
-
         LinearSet<TState> AcceptingStates_value;
         TState StartState_value;
         TransitionTable<std::pair<TState, TChar>, LinearSet<TState>> TransitionFunction_value;
+        std::shared_ptr<CompiledForm> Compiled_value;
     };
 }
 
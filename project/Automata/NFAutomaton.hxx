@@ -1,11 +1,19 @@
 #include "NFAutomaton.h"
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 #include "ArraySlice.h"
+#include "CompiledNFA.h"
 #include "DFAutomaton.h"
 #include "IAutomaton.h"
+#include "LazyDFA.h"
 #include "LinearSet.h"
+#include "SubsetTable.h"
+#include "SymbolTable.h"
 #include "TransitionTable.h"
 
 using namespace Automata;
@@ -19,6 +27,7 @@ NFAutomaton<TState, TChar>::NFAutomaton(TState StartState, LinearSet<TState> Acc
     this->setStartState(StartState);
     this->setAcceptingStates(AcceptingStates);
     this->setTransitionFunction(TransitionFunction);
+    this->Compiled_value = std::make_shared<CompiledForm>();
 }
 
 /// \brief Figures out whether this automaton accepts the given
@@ -26,8 +35,75 @@ NFAutomaton<TState, TChar>::NFAutomaton(TState StartState, LinearSet<TState> Acc
 template<typename TState, typename TChar>
 bool NFAutomaton<TState, TChar>::Accepts(stdx::ArraySlice<TChar> Characters) const
 {
-    return this->ContainsAcceptingState(this->PerformExtendedTransition(this->getStartState(), 
-                                                                        Characters));
+    // Determinize lazily: only the subsets that the input actually
+    // reaches are constructed. The shared lazy DFA keeps its subsets
+    // from one call to the next; a thread that finds it in use runs a
+    // private one instead of waiting.
+    auto& compiled = this->GetCompiledForm();
+    std::unique_lock<std::mutex> lock(compiled.MatcherLock, std::try_to_lock);
+    if (lock.owns_lock())
+        return compiled.Matcher->Accepts(Characters);
+    LazyDFA<TChar> dfa(compiled.Automaton);
+    return dfa.Accepts(Characters);
+}
+
+/// \brief Compiles this automaton to integer state and symbol ids,
+/// with its edges in compressed sparse row form. The start
+/// state is assigned id zero.
+template<typename TState, typename TChar>
+CompiledNFA<TChar> NFAutomaton<TState, TChar>::Compile() const
+{
+    std::vector<TState> states;
+    return this->Compile(states);
+}
+
+/// \brief Compiles this automaton to integer state and symbol ids,
+/// and stores the original state that corresponds to each
+/// state id in the given vector.
+template<typename TState, typename TChar>
+CompiledNFA<TChar> NFAutomaton<TState, TChar>::Compile(std::vector<TState>& States) const
+{
+    return this->Compile(SymbolTable<TChar>(), States);
+}
+
+/// \brief Compiles this automaton, numbering its symbols with the
+/// given symbol table, which is extended with any symbols it
+/// does not contain yet. The original state that corresponds to
+/// each state id is stored in the given vector.
+template<typename TState, typename TChar>
+CompiledNFA<TChar> NFAutomaton<TState, TChar>::Compile(const SymbolTable<TChar>& Symbols, std::vector<TState>& States) const
+{
+    std::unordered_map<TState, uint32_t> stateIds;
+    auto symbols = Symbols;
+    States.clear();
+    auto getStateId = [&](const TState& State) -> uint32_t
+    {
+        auto iter = stateIds.find(State);
+        if (iter != stateIds.end())
+            return iter->second;
+        auto id = (uint32_t)States.size();
+        stateIds[State] = id;
+        States.push_back(State);
+        return id;
+    };
+    auto startId = getStateId(this->getStartState());
+    std::vector<uint32_t> edges;
+    for (auto& item : this->getTransitionFunction().getMap())
+    {
+        auto symbol = symbols.Intern(item.first.second);
+        auto source = getStateId(item.first.first);
+        for (auto& target : item.second.getItems())
+        {
+            edges.push_back(source);
+            edges.push_back(symbol);
+            edges.push_back(getStateId(target));
+        }
+    }
+    std::vector<uint32_t> acceptingIds;
+    for (auto& q : this->getAcceptingStates().getItems())
+        acceptingIds.push_back(getStateId(q));
+
+    return CompiledNFA<TChar>(symbols, (uint32_t)States.size(), startId, acceptingIds, edges, std::vector<uint32_t>());
 }
 
 /// \brief Finds out whether the given sequence of states has a
@@ -45,7 +121,7 @@ template<typename TState, typename TChar>
 LinearSet<TChar> NFAutomaton<TState, TChar>::GetAlphabet() const
 {
     LinearSet<TChar> results;
-    auto transfunc = this->getTransitionFunction();
+    auto& transfunc = this->getTransitionFunction();
     for (auto& item : transfunc.getMap())
         results.Add(item.first.second);
     return results;
@@ -56,7 +132,7 @@ template<typename TState, typename TChar>
 LinearSet<TState> NFAutomaton<TState, TChar>::GetStates() const
 {
     LinearSet<TState> results;
-    auto transfunc = this->getTransitionFunction();
+    auto& transfunc = this->getTransitionFunction();
     for (auto& item : transfunc.getMap())
     {
         results.Add(item.first.first);
@@ -94,54 +170,27 @@ LinearSet<TState> NFAutomaton<TState, TChar>::PerformExtendedTransition(TState S
 template<typename TState, typename TChar>
 LinearSet<TState> NFAutomaton<TState, TChar>::PerformTransition(TState State, TChar Character) const
 {
-    auto transFun = this->getTransitionFunction();
-    return transFun.Apply(std::pair<TState, TChar>(State, Character));
+    return this->getTransitionFunction().Apply(std::pair<TState, TChar>(State, Character));
 }
 
 /// \brief Performs the subset construction on this automaton.
 template<typename TState, typename TChar>
 DFAutomaton<LinearSet<TState>, TChar> NFAutomaton<TState, TChar>::ToDFAutomaton() const
 {
-    return this->ToDFAutomaton(this->GetAlphabet());
-}
-
-/// \brief Performs the subset construction based on the given
-/// alphabet.
-template<typename TState, typename TChar>
-DFAutomaton<LinearSet<TState>, TChar> NFAutomaton<TState, TChar>::ToDFAutomaton(LinearSet<TChar> Alphabet) const
-{
-    LinearSet<TState> startState;
-    startState.Add(this->getStartState());
-    std::unordered_map<std::pair<LinearSet<TState>, TChar>, LinearSet<TState>> transMap;
-    LinearSet<LinearSet<TState>> accStates;
-    LinearSet<LinearSet<TState>> processedStates;
-    LinearSet<LinearSet<TState>> nextStates;
-    LinearSet<TState> initialState;
-    initialState.Add(this->getStartState());
-    nextStates.Add(initialState);
-    while (!nextStates.getIsEmpty())
+    auto& compiled = this->GetCompiledForm();
+    auto& states = compiled.States;
+    SubsetTable subsets;
+    auto dfa = compiled.Automaton->Determinize(subsets, 0);
+    std::vector<LinearSet<TState>> names;
+    names.reserve(subsets.getCount());
+    for (uint32_t id = 0; id < subsets.getCount(); id++)
     {
-        auto last = nextStates.getLast();
-        LinearSet<LinearSet<TState>> accumulatedStates;
-        if (!processedStates.Contains(last))
-        {
-            for (auto& item : Alphabet.getItems())
-            {
-                auto trans = this->PerformAllTransitions(last, item);
-                accumulatedStates.Add(trans);
-                transMap[std::pair<LinearSet<TState>, TChar>(last, item)] = trans;
-            }
-            processedStates.Add(last);
-            if (this->ContainsAcceptingState(last))
-                accStates.Add(last);
-
-        }
-        nextStates.RemoveLast();
-        nextStates.AddAll(accumulatedStates);
+        std::vector<TState> subset;
+        for (auto q : subsets.GetSubset(id))
+            subset.push_back(states[q]);
+        names.push_back(LinearSet<TState>(subset));
     }
-    TransitionTable<std::pair<LinearSet<TState>, TChar>, LinearSet<TState>> transFun(transMap);
-    return DFAutomaton<LinearSet<TState>, TChar>(startState, 
-                                                 accStates, transFun);
+    return dfa.ToDFAutomaton(names);
 }
 
 /// \brief Gets this automaton's set of accepting states.
@@ -151,6 +200,20 @@ LinearSet<TState> NFAutomaton<TState, TChar>::getAcceptingStates() const
     return this->AcceptingStates_value;
 }
 
+/// \brief Gets this automaton's compiled form, which is created on
+/// first use and shared by all copies of this automaton.
+template<typename TState, typename TChar>
+typename NFAutomaton<TState, TChar>::CompiledForm& NFAutomaton<TState, TChar>::GetCompiledForm() const
+{
+    auto& compiled = *this->Compiled_value;
+    std::call_once(compiled.Compiled, [&]()
+    {
+        compiled.Automaton = std::make_shared<CompiledNFA<TChar>>(this->Compile(compiled.States));
+        compiled.Matcher.reset(new LazyDFA<TChar>(compiled.Automaton));
+    });
+    return compiled;
+}
+
 /// \brief Sets this automaton's set of accepting states.
 template<typename TState, typename TChar>
 void NFAutomaton<TState, TChar>::setAcceptingStates(LinearSet<TState> value)
@@ -174,7 +237,7 @@ void NFAutomaton<TState, TChar>::setStartState(TState value)
 
 /// \brief Gets this automaton's transition function.
 template<typename TState, typename TChar>
-TransitionTable<std::pair<TState, TChar>, LinearSet<TState>> NFAutomaton<TState, TChar>::getTransitionFunction() const
+const TransitionTable<std::pair<TState, TChar>, LinearSet<TState>>& NFAutomaton<TState, TChar>::getTransitionFunction() const
 {
     return this->TransitionFunction_value;
 }
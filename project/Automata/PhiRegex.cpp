@@ -1,36 +1,43 @@
 #include "PhiRegex.h"
 
+#include <cstddef>
 #include <memory>
 #include <string>
-#include <utility>
-#include "ENFAutomaton.h"
 #include "IRegex.h"
-#include "LinearSet.h"
-#include "Optional.h"
-#include "RegexState.h"
-#include "TransitionTable.h"
+#include "ThompsonBuilder.h"
 
 using namespace Automata;
 
 PhiRegex::PhiRegex()
 { }
 
-/// \brief Constructs an epsilon-nfa for this regex.
-/// The construction is as follows:    start.
-/// where 'start' is the initial state.
-/// There are no transitions, and no accepting states.
-ENFAutomaton<std::shared_ptr<RegexState>, std::string> PhiRegex::ToENFAutomaton() const
+/// \brief Appends this regex's e-NFA to the given builder.
+/// The construction is as follows:    start end.
+/// where 'start' is the fragment's start state, and 'end' is its
+/// accepting state. There are no transitions, so the accepting
+/// state is unreachable.
+RegexFragment PhiRegex::AppendENFAutomaton(ThompsonBuilder& Builder) const
 {
-    auto startState = std::make_shared<RegexState>();
-    LinearSet<std::shared_ptr<RegexState>> acceptingStates;
-    TransitionTable<std::pair<std::shared_ptr<RegexState>, Optional<std::string>>, LinearSet<std::shared_ptr<RegexState>>> transTable;
-    return ENFAutomaton<std::shared_ptr<RegexState>, std::string>(startState, 
-                                                                  acceptingStates, 
-                                                                  transTable);
+    auto startState = Builder.CreateState();
+    auto endState = Builder.CreateState();
+    return RegexFragment(startState, endState);
 }
 
 /// \brief Gets this regex's string representation.
 std::string PhiRegex::ToString() const
 {
     return "\\p";
+}
+
+/// \brief Gets this regex's hash code, which depends on its
+/// structure only, and is computed when the regex is created.
+std::size_t PhiRegex::getHashCode() const
+{
+    return (std::size_t)PhiKind;
+}
+
+/// \brief Gets this regex's kind.
+RegexKind PhiRegex::getKind() const
+{
+    return PhiKind;
 }
\ No newline at end of file
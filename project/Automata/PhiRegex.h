@@ -1,9 +1,10 @@
 #pragma once
+#include <cstddef>
 #include <memory>
 #include <string>
 #include "ENFAutomaton.h"
 #include "IRegex.h"
-#include "RegexState.h"
+#include "ThompsonBuilder.h"
 
 namespace Automata
 {
@@ -12,13 +13,21 @@ namespace Automata
     {
         PhiRegex();
 
-        /// \brief Constructs an epsilon-nfa for this regex.
-        /// The construction is as follows:    start.
-        /// where 'start' is the initial state.
-        /// There are no transitions, and no accepting states.
-        ENFAutomaton<std::shared_ptr<RegexState>, std::string> ToENFAutomaton() const override;
+        /// \brief Appends this regex's e-NFA to the given builder.
+        /// The construction is as follows:    start end.
+        /// where 'start' is the fragment's start state, and 'end' is its
+        /// accepting state. There are no transitions, so the accepting
+        /// state is unreachable.
+        RegexFragment AppendENFAutomaton(ThompsonBuilder& Builder) const override;
 
         /// \brief Gets this regex's string representation.
         std::string ToString() const override;
+
+        /// \brief Gets this regex's hash code, which depends on its
+        /// structure only, and is computed when the regex is created.
+        std::size_t getHashCode() const override;
+
+        /// \brief Gets this regex's kind.
+        RegexKind getKind() const override;
     };
 }
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include "PositionAutomaton.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ClosureRegex.h"
+#include "ConcatRegex.h"
+#include "IRegex.h"
+#include "LiteralRegex.h"
+#include "SymbolTable.h"
+#include "UnionRegex.h"
+
+using namespace Automata;
+
+/// \brief Computes the position automaton of the given regex,
+/// which must consist of literal, concat, union, closure,
+/// epsilon and phi regexes.
+PositionAutomaton::PositionAutomaton(const IRegex* Regex)
+{
+    this->positionCount = CountPositions(Regex);
+    this->follow.assign(this->positionCount + 1, std::vector<uint32_t>());
+    this->labels.assign(1, 0);
+    auto root = this->Analyze(Regex);
+
+    // The initial position is followed by the regex's first positions,
+    // and is final if the regex matches the empty string.
+    this->follow[0] = root.First;
+    this->finalPositions = root.Last;
+    if (root.Nullable)
+        this->finalPositions.push_back(0);
+    std::sort(this->finalPositions.begin(), this->finalPositions.end());
+    this->isFinal.assign(this->positionCount + 1, false);
+    for (auto p : this->finalPositions)
+        this->isFinal[p] = true;
+
+    // Nested closures add the same follow pairs more than once.
+    for (auto& positions : this->follow)
+    {
+        std::sort(positions.begin(), positions.end());
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+    }
+}
+
+/// \brief Gets the set of positions that can follow the given
+/// position. The initial position is followed by the regex's
+/// first positions.
+const std::vector<uint32_t>& PositionAutomaton::GetFollow(uint32_t Position) const
+{
+    return this->follow[Position];
+}
+
+/// \brief Gets the id of the symbol that labels the given
+/// position, which must not be the initial position.
+uint32_t PositionAutomaton::GetLabel(uint32_t Position) const
+{
+    return this->labels[Position];
+}
+
+/// \brief Checks if the given position is final: a string is
+/// in the regex's language if it can end there.
+bool PositionAutomaton::IsFinal(uint32_t Position) const
+{
+    return this->isFinal[Position];
+}
+
+/// \brief Gets the set of final positions.
+const std::vector<uint32_t>& PositionAutomaton::getFinalPositions() const
+{
+    return this->finalPositions;
+}
+
+/// \brief Gets the number of positions, which is the number of
+/// literals in the regex. The initial position is not counted.
+uint32_t PositionAutomaton::getPositionCount() const
+{
+    return this->positionCount;
+}
+
+/// \brief Gets the table that assigns the regex's symbols their
+/// ids.
+const SymbolTable<std::string>& PositionAutomaton::getSymbolTable() const
+{
+    return this->symbols;
+}
+
+/// \brief Appends the positions of one list to another, by moving
+/// the longer list into the result and appending the shorter
+/// one, so that a position is copied a logarithmic number of
+/// times as the lists grow towards the regex's root.
+std::vector<uint32_t> PositionAutomaton::Merge(std::vector<uint32_t>& Left, std::vector<uint32_t>& Right)
+{
+    if (Left.size() < Right.size())
+        Left.swap(Right);
+    std::vector<uint32_t> result(std::move(Left));
+    result.insert(result.end(), Right.begin(), Right.end());
+    return result;
+}
+
+/// \brief Counts the literals in the given regex.
+uint32_t PositionAutomaton::CountPositions(const IRegex* Regex)
+{
+    switch (Regex->getKind())
+    {
+    case LiteralKind:
+        return 1;
+    case ConcatKind:
+    {
+        auto concat = dynamic_cast<const ConcatRegex*>(Regex);
+        return CountPositions(concat->Left.get()) + CountPositions(concat->Right.get());
+    }
+    case UnionKind:
+    {
+        auto unionRegex = dynamic_cast<const UnionRegex*>(Regex);
+        return CountPositions(unionRegex->Left.get()) + CountPositions(unionRegex->Right.get());
+    }
+    case ClosureKind:
+        return CountPositions(dynamic_cast<const ClosureRegex*>(Regex)->Regex.get());
+    default:
+        return 0;
+    }
+}
+
+/// \brief Computes the nullability and first and last position
+/// sets of the given regex, numbering its literals from
+/// labels.size() onward and adding the follow sets that the
+/// regex induces.
+PositionAutomaton::Analysis PositionAutomaton::Analyze(const IRegex* Regex)
+{
+    Analysis result;
+    switch (Regex->getKind())
+    {
+    case LiteralKind:
+    {
+        auto p = (uint32_t)this->labels.size();
+        this->labels.push_back(this->symbols.Intern(dynamic_cast<const LiteralRegex*>(Regex)->Literal));
+        result.Nullable = false;
+        result.First.push_back(p);
+        result.Last.push_back(p);
+        break;
+    }
+    case ConcatKind:
+    {
+        auto concat = dynamic_cast<const ConcatRegex*>(Regex);
+        auto left = this->Analyze(concat->Left.get());
+        auto right = this->Analyze(concat->Right.get());
+        result.Nullable = left.Nullable && right.Nullable;
+        this->AddFollow(left.Last, right.First);
+        result.First = left.Nullable ? Merge(left.First, right.First) : std::move(left.First);
+        result.Last = right.Nullable ? Merge(left.Last, right.Last) : std::move(right.Last);
+        break;
+    }
+    case UnionKind:
+    {
+        auto unionRegex = dynamic_cast<const UnionRegex*>(Regex);
+        auto left = this->Analyze(unionRegex->Left.get());
+        auto right = this->Analyze(unionRegex->Right.get());
+        result.Nullable = left.Nullable || right.Nullable;
+        result.First = Merge(left.First, right.First);
+        result.Last = Merge(left.Last, right.Last);
+        break;
+    }
+    case ClosureKind:
+        result = this->Analyze(dynamic_cast<const ClosureRegex*>(Regex)->Regex.get());
+        result.Nullable = true;
+        this->AddFollow(result.Last, result.First);
+        break;
+    case EpsilonKind:
+        result.Nullable = true;
+        break;
+    case PhiKind:
+        result.Nullable = false;
+        break;
+    default:
+        throw std::invalid_argument("Regex '" + Regex->ToString() + "' cannot be converted to a position automaton.");
+    }
+    return result;
+}
+
+/// \brief Adds every position in the given first set to the
+/// follow set of every position in the given last set.
+void PositionAutomaton::AddFollow(const std::vector<uint32_t>& Last, const std::vector<uint32_t>& First)
+{
+    for (auto p : Last)
+        this->follow[p].insert(this->follow[p].end(), First.begin(), First.end());
+}
\ No newline at end of file
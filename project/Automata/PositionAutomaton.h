@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "IRegex.h"
+#include "SymbolTable.h"
+
+namespace Automata
+{
+    /// \brief Describes a regex's Glushkov (position) automaton. Every
+    /// literal in the regex is a position, numbered from one in
+    /// left-to-right order, and position zero is the initial state.
+    /// The automaton has an edge from p to q, labeled with q's symbol,
+    /// for every position q in p's follow set, so it has no epsilon
+    /// edges and exactly one state per literal, plus the initial state.
+    /// Sets of positions are sorted lists, so the automaton takes space
+    /// in proportion to its number of edges rather than to the square
+    /// of its number of positions.
+    class PositionAutomaton
+    {
+    public:
+        /// \brief Computes the position automaton of the given regex,
+        /// which must consist of literal, concat, union, closure,
+        /// epsilon and phi regexes.
+        PositionAutomaton(const IRegex* Regex);
+
+        /// \brief Gets the set of positions that can follow the given
+        /// position. The initial position is followed by the regex's
+        /// first positions.
+        const std::vector<uint32_t>& GetFollow(uint32_t Position) const;
+
+        /// \brief Gets the id of the symbol that labels the given
+        /// position, which must not be the initial position.
+        uint32_t GetLabel(uint32_t Position) const;
+
+        /// \brief Checks if the given position is final: a string is
+        /// in the regex's language if it can end there.
+        bool IsFinal(uint32_t Position) const;
+
+        /// \brief Gets the set of final positions.
+        const std::vector<uint32_t>& getFinalPositions() const;
+
+        /// \brief Gets the number of positions, which is the number of
+        /// literals in the regex. The initial position is not counted.
+        uint32_t getPositionCount() const;
+
+        /// \brief Gets the table that assigns the regex's symbols their
+        /// ids.
+        const SymbolTable<std::string>& getSymbolTable() const;
+    private:
+        /// \brief Describes the positions a regex can start and end with,
+        /// and whether it matches the empty string. The lists are not
+        /// sorted.
+        struct Analysis
+        {
+            bool Nullable;
+            std::vector<uint32_t> First;
+            std::vector<uint32_t> Last;
+        };
+
+        /// \brief Appends the positions of one list to another, by moving
+        /// the longer list into the result and appending the shorter
+        /// one, so that a position is copied a logarithmic number of
+        /// times as the lists grow towards the regex's root.
+        static std::vector<uint32_t> Merge(std::vector<uint32_t>& Left, std::vector<uint32_t>& Right);
+
+        /// \brief Counts the literals in the given regex.
+        static uint32_t CountPositions(const IRegex* Regex);
+
+        /// \brief Computes the nullability and first and last position
+        /// sets of the given regex, numbering its literals from
+        /// labels.size() onward and adding the follow sets that the
+        /// regex induces.
+        Analysis Analyze(const IRegex* Regex);
+
+        /// \brief Adds every position in the given first set to the
+        /// follow set of every position in the given last set.
+        void AddFollow(const std::vector<uint32_t>& Last, const std::vector<uint32_t>& First);
+
+        SymbolTable<std::string> symbols;
+        uint32_t positionCount;
+        std::vector<uint32_t> labels;
+        std::vector<std::vector<uint32_t>> follow;
+        std::vector<uint32_t> finalPositions;
+        std::vector<bool> isFinal;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "Prefilter.h"
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUTOMATA_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace Automata;
+
+const std::size_t Prefilter::NoPosition;
+
+/// \brief Creates a prefilter without a literal, which rules out
+/// nothing.
+Prefilter::Prefilter()
+    : isPrefix(false)
+{ }
+
+/// \brief Creates a prefilter for the given literal, which every
+/// match contains. IsPrefix specifies whether every match
+/// starts with it.
+Prefilter::Prefilter(std::string Literal, bool IsPrefix)
+    : literal(Literal), isPrefix(IsPrefix && !Literal.empty())
+{ }
+
+/// \brief Finds the first occurrence of the given literal in the
+/// given byte string that starts at or after the given offset,
+/// or returns NoPosition if there is none.
+/// Single bytes are found by memchr. Longer literals are found by
+/// comparing their first and last bytes against sixteen candidate
+/// positions at once, and only candidates at which both bytes
+/// match are compared in full.
+std::size_t Prefilter::FindLiteral(const char* Data, std::size_t Length, std::size_t From, const std::string& Literal)
+{
+    auto size = Literal.size();
+    if (size == 0)
+        return From <= Length ? From : NoPosition;
+    if (From > Length || Length - From < size)
+        return NoPosition;
+    if (size == 1)
+    {
+        auto result = (const char*)std::memchr(Data + From, Literal[0], Length - From);
+        return result == nullptr ? NoPosition : (std::size_t)(result - Data);
+    }
+
+    // The last position at which the literal can start.
+    auto last = Length - size;
+    auto i = From;
+#ifdef AUTOMATA_SSE2
+    auto firstByte = _mm_set1_epi8(Literal[0]);
+    auto lastByte = _mm_set1_epi8(Literal[size - 1]);
+    for (; i <= last && last - i >= 15; i += 16)
+    {
+        auto heads = _mm_cmpeq_epi8(firstByte, _mm_loadu_si128((const __m128i*)(Data + i)));
+        auto tails = _mm_cmpeq_epi8(lastByte, _mm_loadu_si128((const __m128i*)(Data + i + size - 1)));
+        auto mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(heads, tails));
+        for (unsigned bit = 0; mask != 0; bit++, mask >>= 1)
+            if ((mask & 1) != 0 && std::memcmp(Data + i + bit + 1, Literal.data() + 1, size - 2) == 0)
+                return i + bit;
+    }
+#endif
+    while (i <= last)
+    {
+        auto result = (const char*)std::memchr(Data + i, Literal[0], last - i + 1);
+        if (result == nullptr)
+            return NoPosition;
+        i = (std::size_t)(result - Data);
+        if (std::memcmp(Data + i + 1, Literal.data() + 1, size - 1) == 0)
+            return i;
+        i++;
+    }
+    return NoPosition;
+}
+
+/// \brief Finds the first position at or after the given offset
+/// at which a match may start, or returns NoPosition if the
+/// given byte string cannot contain a match after that offset.
+/// Unless the literal is a prefix, that position is the given
+/// offset itself whenever the literal occurs after it.
+std::size_t Prefilter::FindCandidate(const char* Data, std::size_t Length, std::size_t From) const
+{
+    if (this->literal.empty())
+        return From <= Length ? From : NoPosition;
+
+    auto position = FindLiteral(Data, Length, From, this->literal);
+    if (this->isPrefix || position == NoPosition)
+        return position;
+    else
+        return From;
+}
+
+/// \brief Checks if the given byte string may be a match as a
+/// whole.
+bool Prefilter::MayAccept(const char* Data, std::size_t Length) const
+{
+    if (this->isPrefix)
+        return Length >= this->literal.size() && std::memcmp(Data, this->literal.data(), this->literal.size()) == 0;
+    else
+        return this->literal.empty() || FindLiteral(Data, Length, 0, this->literal) != NoPosition;
+}
+
+/// \brief Checks if every match starts with the literal.
+bool Prefilter::getIsPrefix() const
+{
+    return this->isPrefix;
+}
+
+/// \brief Gets the literal that every match contains, or the
+/// empty string if there is no such literal.
+const std::string& Prefilter::getLiteral() const
+{
+    return this->literal;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace Automata
+{
+    /// \brief Defines a prefilter that rules out input which cannot
+    /// contain a match, based on a literal that every match contains.
+    /// Literals are found with a vectorized scan, which is much faster
+    /// than stepping an automaton byte by byte, so the automaton only
+    /// has to run on input that contains the literal. If every match
+    /// starts with the literal, matches can only start where the
+    /// literal occurs.
+    /// A literal that is not a prefix does not narrow the input down
+    /// any further: a match that contains an occurrence may start
+    /// arbitrarily far before it and end arbitrarily far after it, so
+    /// there is no window around the occurrence outside which the
+    /// automaton could skip the input. Such a literal only rules out
+    /// input that does not contain it at all, and once it occurs, a
+    /// searcher still runs its automaton over the whole input.
+    class Prefilter
+    {
+    public:
+        /// \brief A position that denotes the absence of a candidate.
+        static const std::size_t NoPosition = (std::size_t)-1;
+
+        /// \brief Creates a prefilter without a literal, which rules out
+        /// nothing.
+        Prefilter();
+
+        /// \brief Creates a prefilter for the given literal, which every
+        /// match contains. IsPrefix specifies whether every match
+        /// starts with it.
+        Prefilter(std::string Literal, bool IsPrefix);
+
+        /// \brief Finds the first occurrence of the given literal in the
+        /// given byte string that starts at or after the given offset,
+        /// or returns NoPosition if there is none.
+        static std::size_t FindLiteral(const char* Data, std::size_t Length, std::size_t From, const std::string& Literal);
+
+        /// \brief Finds the first position at or after the given offset
+        /// at which a match may start, or returns NoPosition if the
+        /// given byte string cannot contain a match after that offset.
+        /// Unless the literal is a prefix, that position is the given
+        /// offset itself whenever the literal occurs after it.
+        std::size_t FindCandidate(const char* Data, std::size_t Length, std::size_t From) const;
+
+        /// \brief Checks if the given byte string may be a match as a
+        /// whole.
+        bool MayAccept(const char* Data, std::size_t Length) const;
+
+        /// \brief Checks if every match starts with the literal.
+        bool getIsPrefix() const;
+
+        /// \brief Gets the literal that every match contains, or the
+        /// empty string if there is no such literal.
+        const std::string& getLiteral() const;
+    private:
+        std::string literal;
+        bool isPrefix;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "RegexFactory.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "ClosureRegex.h"
+#include "ConcatRegex.h"
+#include "EpsilonRegex.h"
+#include "IRegex.h"
+#include "LiteralRegex.h"
+#include "PhiRegex.h"
+#include "UnionRegex.h"
+
+using namespace Automata;
+
+/// \brief Creates an empty regex factory.
+RegexFactory::RegexFactory()
+    : epsilon(std::make_shared<EpsilonRegex>()), phi(std::make_shared<PhiRegex>())
+{ }
+
+/// \brief Creates the closure of the given regex.
+std::shared_ptr<IRegex> RegexFactory::CreateClosure(std::shared_ptr<IRegex> Regex)
+{
+    return this->Intern(std::make_shared<ClosureRegex>(Regex));
+}
+
+/// \brief Creates the concatenation of the given regexes.
+std::shared_ptr<IRegex> RegexFactory::CreateConcat(std::shared_ptr<IRegex> Left, std::shared_ptr<IRegex> Right)
+{
+    return this->Intern(std::make_shared<ConcatRegex>(Left, Right));
+}
+
+/// \brief Gets the epsilon regex.
+std::shared_ptr<IRegex> RegexFactory::CreateEpsilon() const
+{
+    return this->epsilon;
+}
+
+/// \brief Creates a literal regex for the given symbol.
+std::shared_ptr<IRegex> RegexFactory::CreateLiteral(std::string Literal)
+{
+    return this->Intern(std::make_shared<LiteralRegex>(Literal));
+}
+
+/// \brief Gets the phi regex.
+std::shared_ptr<IRegex> RegexFactory::CreatePhi() const
+{
+    return this->phi;
+}
+
+/// \brief Creates the union of the given regexes.
+std::shared_ptr<IRegex> RegexFactory::CreateUnion(std::shared_ptr<IRegex> Left, std::shared_ptr<IRegex> Right)
+{
+    return this->Intern(std::make_shared<UnionRegex>(Left, Right));
+}
+
+/// \brief Gets the number of distinct regexes this factory has
+/// created.
+std::size_t RegexFactory::getCount() const
+{
+    return this->regexes.size() + 2;
+}
+
+/// \brief Checks if the given regexes have the same kind and
+/// literal, and the same operands.
+bool RegexFactory::ShallowEquals(const IRegex* Left, const IRegex* Right)
+{
+    if (Left->getKind() != Right->getKind() || Left->getHashCode() != Right->getHashCode())
+        return false;
+
+    switch (Left->getKind())
+    {
+    case LiteralKind:
+        return dynamic_cast<const LiteralRegex*>(Left)->Literal == dynamic_cast<const LiteralRegex*>(Right)->Literal;
+    case ConcatKind:
+    {
+        auto left = dynamic_cast<const ConcatRegex*>(Left);
+        auto right = dynamic_cast<const ConcatRegex*>(Right);
+        return left->Left == right->Left && left->Right == right->Right;
+    }
+    case UnionKind:
+    {
+        auto left = dynamic_cast<const UnionRegex*>(Left);
+        auto right = dynamic_cast<const UnionRegex*>(Right);
+        return left->Left == right->Left && left->Right == right->Right;
+    }
+    case ClosureKind:
+        return dynamic_cast<const ClosureRegex*>(Left)->Regex == dynamic_cast<const ClosureRegex*>(Right)->Regex;
+    default:
+        return true;
+    }
+}
+
+/// \brief Finds the regex that is structurally identical to the
+/// given regex, or adds the given regex to this factory if
+/// there is no such regex yet.
+std::shared_ptr<IRegex> RegexFactory::Intern(std::shared_ptr<IRegex> Regex)
+{
+    auto range = this->regexes.equal_range(Regex->getHashCode());
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+        if (ShallowEquals(iter->second.get(), Regex.get()))
+            return iter->second;
+    }
+    this->regexes.insert(std::make_pair(Regex->getHashCode(), Regex));
+    return Regex;
+}
\ No newline at end of file
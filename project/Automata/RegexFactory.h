@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "IRegex.h"
+
+namespace Automata
+{
+    /// \brief Defines a factory that hash-conses regexes: structurally
+    /// identical regexes that are created by the same factory are the
+    /// same object. Since the operands of every regex have been
+    /// interned already, two regexes are identical if they have the
+    /// same kind and literal and their operands are the same objects,
+    /// so interning a regex takes constant time, as does comparing
+    /// two interned regexes.
+    class RegexFactory
+    {
+    public:
+        /// \brief Creates an empty regex factory.
+        RegexFactory();
+
+        /// \brief Creates the closure of the given regex.
+        std::shared_ptr<IRegex> CreateClosure(std::shared_ptr<IRegex> Regex);
+
+        /// \brief Creates the concatenation of the given regexes.
+        std::shared_ptr<IRegex> CreateConcat(std::shared_ptr<IRegex> Left, std::shared_ptr<IRegex> Right);
+
+        /// \brief Gets the epsilon regex.
+        std::shared_ptr<IRegex> CreateEpsilon() const;
+
+        /// \brief Creates a literal regex for the given symbol.
+        std::shared_ptr<IRegex> CreateLiteral(std::string Literal);
+
+        /// \brief Gets the phi regex.
+        std::shared_ptr<IRegex> CreatePhi() const;
+
+        /// \brief Creates the union of the given regexes.
+        std::shared_ptr<IRegex> CreateUnion(std::shared_ptr<IRegex> Left, std::shared_ptr<IRegex> Right);
+
+        /// \brief Gets the number of distinct regexes this factory has
+        /// created.
+        std::size_t getCount() const;
+    private:
+        /// \brief Checks if the given regexes have the same kind and
+        /// literal, and the same operands.
+        static bool ShallowEquals(const IRegex* Left, const IRegex* Right);
+
+        /// \brief Finds the regex that is structurally identical to the
+        /// given regex, or adds the given regex to this factory if
+        /// there is no such regex yet.
+        std::shared_ptr<IRegex> Intern(std::shared_ptr<IRegex> Regex);
+
+        std::unordered_multimap<std::size_t, std::shared_ptr<IRegex>> regexes;
+        std::shared_ptr<IRegex> epsilon;
+        std::shared_ptr<IRegex> phi;
+    };
+}
\ No newline at end of file
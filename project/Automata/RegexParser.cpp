@@ -12,15 +12,15 @@ std::shared_ptr<IRegex> RegexParser::ParseSimpleRegex(char val)
 		this->data->get(val);
 		if (val == 'e')
 		{
-			return std::make_shared<EpsilonRegex>();
+			return this->factory.CreateEpsilon();
 		}
 		else if (val == 'p')
 		{
-			return std::make_shared<PhiRegex>();
+			return this->factory.CreatePhi();
 		}
 	}
 	auto str = std::string(1, val);
-	return std::make_shared<LiteralRegex>(str);
+	return this->factory.CreateLiteral(str);
 }
 
 std::shared_ptr<IRegex> RegexParser::ParsePrimaryRegex(char val)
@@ -40,7 +40,7 @@ std::shared_ptr<IRegex> RegexParser::ParsePrimaryRegex(char val)
 
 	if (val == '*')
 	{
-		auto closure = std::make_shared<ClosureRegex>(first);
+		auto closure = this->factory.CreateClosure(first);
 		if (!this->data->get(val)) { return closure; }
 		else if (val == ')' || val == '+')
 		{
@@ -48,12 +48,12 @@ std::shared_ptr<IRegex> RegexParser::ParsePrimaryRegex(char val)
 			return closure;
 		}
 		auto next = ParsePrimaryRegex(val);
-		return std::make_shared<ConcatRegex>(closure, next);
+		return this->factory.CreateConcat(closure, next);
 	}
 	else if (val != ')' && val != '+')
 	{
 		auto second = ParsePrimaryRegex(val);
-		return std::make_shared<ConcatRegex>(first, second);
+		return this->factory.CreateConcat(first, second);
 	}
 	else // These don't belong to us.
 	{
@@ -71,7 +71,7 @@ std::shared_ptr<IRegex> RegexParser::ParseRegex(char val)
 	if (val == '+')
 	{
 		auto second = ParseRegex();
-		return std::make_shared<UnionRegex>(first, second);
+		return this->factory.CreateUnion(first, second);
 	}
 	else
 	{
@@ -1,5 +1,4 @@
 #pragma once
-#include "RegexState.h"
 #include "IRegex.h"
 #include "PhiRegex.h"
 #include "LiteralRegex.h"
@@ -8,6 +7,7 @@
 #include "ConcatRegex.h"
 #include "ClosureRegex.h"
 #include "HashExtensions.h"
+#include "RegexFactory.h"
 
 class RegexParser
 {
@@ -18,6 +18,7 @@ public:
 
 private:
 	std::istream* data;
+	RegexFactory factory;
 	std::shared_ptr<IRegex> ParseSimpleRegex(char Value);
 	std::shared_ptr<IRegex> ParsePrimaryRegex(char Value);
 	std::shared_ptr<IRegex> ParseRegex(char Value);
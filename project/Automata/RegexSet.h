@@ -0,0 +1,111 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ArraySlice.h"
+#include "CompiledDFA.h"
+#include "CompiledNFA.h"
+
+namespace Automata
+{
+    /// \brief Defines a set of patterns that are matched against the
+    /// same input at once. Patterns are numbered in the order in which
+    /// they are added, and they are combined into product DFAs whose
+    /// states are labeled with the ids of the patterns that accept in
+    /// them, so a single pass over the input finds every pattern that
+    /// accepts it. Product automata can grow exponentially in the
+    /// number of patterns, so patterns are packed into groups: a new
+    /// group is started whenever adding a pattern to the current group
+    /// would take its product automaton past a state limit. The input
+    /// is scanned once per group.
+    template<typename TChar>
+    class RegexSet
+    {
+    public:
+        /// \brief The default maximal number of states in a group's
+        /// product automaton.
+        static const uint32_t DefaultMaxStates = 10000;
+
+        /// \brief Creates an empty pattern set with the default state
+        /// limit.
+        RegexSet();
+
+        /// \brief Creates an empty pattern set whose groups' product
+        /// automata have at most the given number of states, unless a
+        /// single pattern's automaton has more states than that.
+        RegexSet(uint32_t MaxStates);
+
+        /// \brief Adds the language that the given DFA accepts to this
+        /// set, and returns its pattern id.
+        uint32_t Add(const CompiledDFA<TChar>& Automaton);
+
+        /// \brief Adds the language that the given NFA or e-NFA accepts
+        /// to this set, and returns its pattern id.
+        uint32_t Add(const CompiledNFA<TChar>& Automaton);
+
+        /// \brief Finds the ids of all patterns that accept the given
+        /// string of symbols, and stores them in the given vector in
+        /// ascending order.
+        void Match(stdx::ArraySlice<TChar> Characters, std::vector<uint32_t>& Patterns) const;
+
+        /// \brief Finds the ids of all patterns that accept the given
+        /// string of bytes, and stores them in the given vector in
+        /// ascending order.
+        void Match(const char* Data, std::size_t Length, std::vector<uint32_t>& Patterns) const;
+
+        /// \brief Gets the product automaton of the group with the given
+        /// index.
+        const CompiledDFA<TChar>& GetGroupAutomaton(uint32_t Group) const;
+
+        /// \brief Gets the number of patterns that accept in the given
+        /// state of the given group's product automaton.
+        uint32_t GetMatchCount(uint32_t Group, uint32_t State) const;
+
+        /// \brief Gets the ids of the patterns that accept in the given
+        /// state of the given group's product automaton, in ascending
+        /// order.
+        const uint32_t* GetMatches(uint32_t Group, uint32_t State) const;
+
+        /// \brief Gets the number of groups the patterns have been packed
+        /// into.
+        uint32_t getGroupCount() const;
+
+        /// \brief Gets the maximal number of states in a group's product
+        /// automaton.
+        uint32_t getMaxStates() const;
+
+        /// \brief Gets the number of patterns in this set.
+        uint32_t getPatternCount() const;
+    private:
+        /// \brief Describes a group of patterns: its product automaton,
+        /// and the pattern ids of every state, in compressed sparse row
+        /// form.
+        struct Group
+        {
+            CompiledDFA<TChar> Automaton;
+            std::vector<uint32_t> MatchOffsets;
+            std::vector<uint32_t> MatchPatterns;
+        };
+
+        /// \brief Creates a group that contains only the pattern with
+        /// the given id and minimal automaton.
+        static Group CreateGroup(const CompiledDFA<TChar>& Automaton, uint32_t Pattern);
+
+        /// \brief Creates the product of the given group and the pattern
+        /// with the given id and automaton, and stores it in the given
+        /// group. Returns false, leaving the result unspecified, if the
+        /// product has more than the given number of states.
+        static bool TryCreateProduct(const Group& Left, const CompiledDFA<TChar>& Right, uint32_t Pattern, uint32_t MaxStates, Group& Result);
+
+        /// \brief Minimizes the given product automaton, whose states
+        /// accept the given lists of patterns, and turns it into a
+        /// group.
+        static Group CreateMinimalGroup(const CompiledDFA<TChar>& Automaton, const std::vector<std::vector<uint32_t>>& Matches);
+
+        uint32_t maxStates;
+        uint32_t patternCount;
+        std::vector<Group> groups;
+    };
+}
+
+#include "RegexSet.hxx"
\ No newline at end of file
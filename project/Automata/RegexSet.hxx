@@ -0,0 +1,268 @@
+#include "RegexSet.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "ArraySlice.h"
+#include "CompiledDFA.h"
+#include "CompiledNFA.h"
+#include "SymbolTable.h"
+
+using namespace Automata;
+
+template<typename TChar>
+const uint32_t RegexSet<TChar>::DefaultMaxStates;
+
+/// \brief Creates an empty pattern set with the default state
+/// limit.
+template<typename TChar>
+RegexSet<TChar>::RegexSet()
+    : maxStates(DefaultMaxStates), patternCount(0)
+{ }
+
+/// \brief Creates an empty pattern set whose groups' product
+/// automata have at most the given number of states, unless a
+/// single pattern's automaton has more states than that.
+template<typename TChar>
+RegexSet<TChar>::RegexSet(uint32_t MaxStates)
+    : maxStates(MaxStates), patternCount(0)
+{ }
+
+/// \brief Adds the language that the given DFA accepts to this
+/// set, and returns its pattern id.
+template<typename TChar>
+uint32_t RegexSet<TChar>::Add(const CompiledDFA<TChar>& Automaton)
+{
+    auto automaton = Automaton.Minimize();
+    auto pattern = this->patternCount++;
+    if (!this->groups.empty())
+    {
+        Group product;
+        if (TryCreateProduct(this->groups.back(), automaton, pattern, this->maxStates, product))
+        {
+            this->groups.back() = std::move(product);
+            return pattern;
+        }
+    }
+    this->groups.push_back(CreateGroup(automaton, pattern));
+    return pattern;
+}
+
+/// \brief Adds the language that the given NFA or e-NFA accepts
+/// to this set, and returns its pattern id.
+template<typename TChar>
+uint32_t RegexSet<TChar>::Add(const CompiledNFA<TChar>& Automaton)
+{
+    return this->Add(Automaton.Determinize());
+}
+
+/// \brief Creates a group that contains only the pattern with
+/// the given id and minimal automaton.
+template<typename TChar>
+typename RegexSet<TChar>::Group RegexSet<TChar>::CreateGroup(const CompiledDFA<TChar>& Automaton, uint32_t Pattern)
+{
+    Group result;
+    result.Automaton = Automaton;
+    result.MatchOffsets.push_back(0);
+    for (uint32_t q = 0; q < Automaton.getStateCount(); q++)
+    {
+        if (Automaton.IsAcceptingState(q))
+            result.MatchPatterns.push_back(Pattern);
+        result.MatchOffsets.push_back((uint32_t)result.MatchPatterns.size());
+    }
+    return result;
+}
+
+/// \brief Creates the product of the given group and the pattern
+/// with the given id and automaton, and stores it in the given
+/// group. Returns false, leaving the result unspecified, if the
+/// product has more than the given number of states.
+template<typename TChar>
+bool RegexSet<TChar>::TryCreateProduct(const Group& Left, const CompiledDFA<TChar>& Right, uint32_t Pattern, uint32_t MaxStates, Group& Result)
+{
+    // The product's alphabet is the union of both alphabets. Every
+    // symbol is mapped to its column in either automaton; symbols
+    // that only one of them knows are "other" symbols to the other.
+    auto symbols = Left.Automaton.getSymbolTable();
+    for (auto& symbol : Right.getSymbolTable().getSymbols())
+        symbols.Intern(symbol);
+    auto symbolCount = symbols.getCount();
+    auto rowLength = symbolCount + 1;
+    std::vector<uint32_t> leftColumns(rowLength);
+    std::vector<uint32_t> rightColumns(rowLength);
+    for (uint32_t a = 0; a < symbolCount; a++)
+    {
+        leftColumns[a] = Left.Automaton.GetSymbolId(symbols.GetSymbol(a));
+        rightColumns[a] = Right.GetSymbolId(symbols.GetSymbol(a));
+    }
+    leftColumns[symbolCount] = Left.Automaton.getOtherSymbol();
+    rightColumns[symbolCount] = Right.getOtherSymbol();
+
+    // Pairs of states are numbered in the order in which they are
+    // discovered, so the pair list doubles as the worklist. The pair
+    // of dead states is the product's dead state.
+    std::vector<uint64_t> pairs(1, 0);
+    std::unordered_map<uint64_t, uint32_t> ids;
+    ids[0] = CompiledDFA<TChar>::DeadState;
+    auto startPair = ((uint64_t)Left.Automaton.getStartState() << 32) | Right.getStartState();
+    if (startPair != 0)
+    {
+        ids[startPair] = 1;
+        pairs.push_back(startPair);
+    }
+    std::vector<uint32_t> transitions(rowLength, CompiledDFA<TChar>::DeadState);
+    for (uint32_t id = 1; id < (uint32_t)pairs.size(); id++)
+    {
+        auto left = (uint32_t)(pairs[id] >> 32);
+        auto right = (uint32_t)pairs[id];
+        for (uint32_t a = 0; a < rowLength; a++)
+        {
+            auto target = ((uint64_t)Left.Automaton.PerformTransition(left, leftColumns[a]) << 32)
+                        | Right.PerformTransition(right, rightColumns[a]);
+            auto iter = ids.find(target);
+            if (iter == ids.end())
+            {
+                if (pairs.size() >= MaxStates)
+                    return false;
+                iter = ids.insert(std::make_pair(target, (uint32_t)pairs.size())).first;
+                pairs.push_back(target);
+            }
+            transitions.push_back(iter->second);
+        }
+    }
+
+    auto stateCount = (uint32_t)pairs.size();
+    std::vector<uint64_t> accepting((stateCount + 63) / 64, 0);
+    std::vector<std::vector<uint32_t>> matches(stateCount);
+    for (uint32_t id = 0; id < stateCount; id++)
+    {
+        auto left = (uint32_t)(pairs[id] >> 32);
+        auto right = (uint32_t)pairs[id];
+        matches[id].assign(Left.MatchPatterns.begin() + Left.MatchOffsets[left],
+                           Left.MatchPatterns.begin() + Left.MatchOffsets[left + 1]);
+        if (Right.IsAcceptingState(right))
+            matches[id].push_back(Pattern);
+        if (!matches[id].empty())
+            accepting[id >> 6] |= (uint64_t)1 << (id & 63);
+    }
+    auto startState = startPair == 0 ? CompiledDFA<TChar>::DeadState : 1;
+    CompiledDFA<TChar> product(symbols, stateCount, startState, transitions, accepting);
+    Result = CreateMinimalGroup(product, matches);
+    return true;
+}
+
+/// \brief Minimizes the given product automaton, whose states
+/// accept the given lists of patterns, and turns it into a
+/// group.
+template<typename TChar>
+typename RegexSet<TChar>::Group RegexSet<TChar>::CreateMinimalGroup(const CompiledDFA<TChar>& Automaton, const std::vector<std::vector<uint32_t>>& Matches)
+{
+    // States are labeled by their lists of patterns, so that only
+    // states that accept the same patterns can be merged. The empty
+    // list gets label zero, which keeps the dead state's label apart
+    // from those of the accepting states.
+    std::map<std::vector<uint32_t>, uint32_t> labelIds;
+    labelIds[std::vector<uint32_t>()] = 0;
+    std::vector<uint32_t> labels(Matches.size());
+    for (std::size_t q = 0; q < Matches.size(); q++)
+        labels[q] = labelIds.insert(std::make_pair(Matches[q], (uint32_t)labelIds.size())).first->second;
+
+    std::vector<uint32_t> stateMap;
+    Group result;
+    result.Automaton = Automaton.Minimize(labels, stateMap);
+    std::vector<const std::vector<uint32_t>*> stateMatches(result.Automaton.getStateCount(), nullptr);
+    for (std::size_t q = 0; q < Matches.size(); q++)
+        if (stateMap[q] != CompiledDFA<TChar>::NoState)
+            stateMatches[stateMap[q]] = &Matches[q];
+    result.MatchOffsets.push_back(0);
+    for (auto matches : stateMatches)
+    {
+        if (matches != nullptr)
+            result.MatchPatterns.insert(result.MatchPatterns.end(), matches->begin(), matches->end());
+        result.MatchOffsets.push_back((uint32_t)result.MatchPatterns.size());
+    }
+    return result;
+}
+
+/// \brief Finds the ids of all patterns that accept the given
+/// string of symbols, and stores them in the given vector in
+/// ascending order.
+template<typename TChar>
+void RegexSet<TChar>::Match(stdx::ArraySlice<TChar> Characters, std::vector<uint32_t>& Patterns) const
+{
+    Patterns.clear();
+    for (uint32_t g = 0; g < (uint32_t)this->groups.size(); g++)
+    {
+        auto& automaton = this->groups[g].Automaton;
+        auto ids = automaton.TranslateSymbols(Characters);
+        auto state = automaton.PerformExtendedTransition(automaton.getStartState(), ids.data(), ids.size());
+        Patterns.insert(Patterns.end(), this->GetMatches(g, state), this->GetMatches(g, state) + this->GetMatchCount(g, state));
+    }
+}
+
+/// \brief Finds the ids of all patterns that accept the given
+/// string of bytes, and stores them in the given vector in
+/// ascending order.
+template<typename TChar>
+void RegexSet<TChar>::Match(const char* Data, std::size_t Length, std::vector<uint32_t>& Patterns) const
+{
+    Patterns.clear();
+    for (uint32_t g = 0; g < (uint32_t)this->groups.size(); g++)
+    {
+        auto& automaton = this->groups[g].Automaton;
+        auto state = automaton.PerformExtendedTransition(automaton.getStartState(), Data, Length);
+        Patterns.insert(Patterns.end(), this->GetMatches(g, state), this->GetMatches(g, state) + this->GetMatchCount(g, state));
+    }
+}
+
+/// \brief Gets the product automaton of the group with the given
+/// index.
+template<typename TChar>
+const CompiledDFA<TChar>& RegexSet<TChar>::GetGroupAutomaton(uint32_t Group) const
+{
+    return this->groups[Group].Automaton;
+}
+
+/// \brief Gets the number of patterns that accept in the given
+/// state of the given group's product automaton.
+template<typename TChar>
+uint32_t RegexSet<TChar>::GetMatchCount(uint32_t Group, uint32_t State) const
+{
+    auto& offsets = this->groups[Group].MatchOffsets;
+    return offsets[State + 1] - offsets[State];
+}
+
+/// \brief Gets the ids of the patterns that accept in the given
+/// state of the given group's product automaton, in ascending
+/// order.
+template<typename TChar>
+const uint32_t* RegexSet<TChar>::GetMatches(uint32_t Group, uint32_t State) const
+{
+    return this->groups[Group].MatchPatterns.data() + this->groups[Group].MatchOffsets[State];
+}
+
+/// \brief Gets the number of groups the patterns have been packed
+/// into.
+template<typename TChar>
+uint32_t RegexSet<TChar>::getGroupCount() const
+{
+    return (uint32_t)this->groups.size();
+}
+
+/// \brief Gets the maximal number of states in a group's product
+/// automaton.
+template<typename TChar>
+uint32_t RegexSet<TChar>::getMaxStates() const
+{
+    return this->maxStates;
+}
+
+/// \brief Gets the number of patterns in this set.
+template<typename TChar>
+uint32_t RegexSet<TChar>::getPatternCount() const
+{
+    return this->patternCount;
+}
\ No newline at end of file
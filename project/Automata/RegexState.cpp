@@ -1,8 +0,0 @@
-#include "RegexState.h"
-
-
-using namespace Automata;
-
-/// \brief Creates a unique regex state.
-RegexState::RegexState()
-{ }
\ No newline at end of file
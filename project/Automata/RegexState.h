@@ -1,12 +0,0 @@
-#pragma once
-
-namespace Automata
-{
-    /// \brief Defines a regex state, which is used in conjunction with
-    /// reference equality.
-    struct RegexState
-    {
-        /// \brief Creates a unique regex state.
-        RegexState();
-    };
-}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "CompiledDFA.h"
+#include "CompiledNFA.h"
+#include "Prefilter.h"
+
+namespace Automata
+{
+    /// \brief Describes a match that a searcher found: the half-open
+    /// range of byte offsets [Start, End).
+    struct SearchMatch
+    {
+        std::size_t Start;
+        std::size_t End;
+    };
+
+    /// \brief Defines a searcher that finds the substrings of a byte
+    /// string that an automaton accepts. Matches are leftmost-longest:
+    /// of all matches, the one that starts first is chosen, and of the
+    /// matches that start there, the longest one.
+    /// A search takes two passes, each of which is a plain DFA run.
+    /// A DFA for the reversals of all strings that start with a match
+    /// runs backwards over the input once, and accepts at exactly the
+    /// positions at which a match starts. The anchored DFA then runs
+    /// forwards from the leftmost of those positions, to find the
+    /// longest match that starts there. FindAll marks the starts of
+    /// all matches in a single backward pass, so a search never takes
+    /// time quadratic in the length of the input to find where matches
+    /// start.
+    /// Before any automaton runs, the input is scanned for a literal
+    /// that every match contains, so input without it is skipped at
+    /// memory speed.
+    /// Symbols that are not in the automaton's alphabet never occur in
+    /// a match.
+    template<typename TChar>
+    class Searcher
+    {
+    public:
+        /// \brief Creates a searcher for the language that the given DFA
+        /// accepts.
+        Searcher(const CompiledDFA<TChar>& Automaton);
+
+        /// \brief Creates a searcher for the language that the given NFA
+        /// or e-NFA accepts.
+        Searcher(const CompiledNFA<TChar>& Automaton);
+
+        /// \brief Finds the leftmost-longest match in the given byte
+        /// string that starts at or after the given offset. Returns
+        /// false if there is no such match. The match may be empty.
+        bool Find(const char* Data, std::size_t Length, std::size_t From, SearchMatch& Result) const;
+
+        /// \brief Finds all non-empty, non-overlapping leftmost-longest
+        /// matches in the given byte string, in order.
+        std::vector<SearchMatch> FindAll(const char* Data, std::size_t Length) const;
+
+        /// \brief Gets the minimal DFA that recognizes matches that
+        /// start at a given position.
+        const CompiledDFA<TChar>& getForwardAutomaton() const;
+
+        /// \brief Gets the prefilter that rules out input without
+        /// matches.
+        const Prefilter& getPrefilter() const;
+
+        /// \brief Gets the minimal DFA that accepts the reversal of every
+        /// string that starts with a match.
+        const CompiledDFA<TChar>& getReverseAutomaton() const;
+    private:
+        /// \brief Creates the reverse automaton and the prefilter from
+        /// the forward automaton.
+        void Initialize();
+
+        /// \brief Runs the reverse automaton backwards over the given
+        /// byte string, down to the given offset, and calls the given
+        /// function with every offset at or after it at which a match
+        /// starts, from right to left.
+        template<typename TStartFunction>
+        void FindStarts(const char* Data, std::size_t Length, std::size_t From, TStartFunction OnStart) const;
+
+        /// \brief Finds the offset at which the longest match that
+        /// starts at the given offset ends, or returns false if no
+        /// match starts there.
+        bool MatchAt(const char* Data, std::size_t Length, std::size_t Start, std::size_t& End) const;
+
+        CompiledDFA<TChar> forward;
+        CompiledDFA<TChar> reverse;
+        Prefilter prefilter;
+    };
+}
+
+#include "Searcher.hxx"
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "Searcher.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "CompiledDFA.h"
+#include "CompiledNFA.h"
+#include "Prefilter.h"
+
+using namespace Automata;
+
+/// \brief Creates a searcher for the language that the given DFA
+/// accepts.
+template<typename TChar>
+Searcher<TChar>::Searcher(const CompiledDFA<TChar>& Automaton)
+    : forward(Automaton.Minimize())
+{
+    this->Initialize();
+}
+
+/// \brief Creates a searcher for the language that the given NFA
+/// or e-NFA accepts.
+template<typename TChar>
+Searcher<TChar>::Searcher(const CompiledNFA<TChar>& Automaton)
+    : forward(Automaton.Determinize().Minimize())
+{
+    this->Initialize();
+}
+
+/// \brief Creates the reverse automaton and the prefilter from
+/// the forward automaton.
+template<typename TChar>
+void Searcher<TChar>::Initialize()
+{
+    auto& symbols = this->forward.getSymbolTable();
+    auto stateCount = this->forward.getStateCount();
+    auto symbolCount = this->forward.getOtherSymbol();
+
+    bool isPrefix;
+    auto literal = this->forward.FindRequiredLiteral(isPrefix);
+    this->prefilter = Prefilter(literal, isPrefix);
+
+    // The reverse automaton runs the forward automaton's edges
+    // backwards, from a fresh state that has an epsilon edge to every
+    // accepting state. Edges into the dead state are useless. Another
+    // fresh start state, which loops on every symbol, precedes it, so
+    // that any suffix may follow a match.
+    auto matchStart = stateCount;
+    auto loopStart = stateCount + 1;
+    std::vector<uint32_t> edges;
+    std::vector<uint32_t> epsilonEdges;
+    for (uint32_t q = 1; q < stateCount; q++)
+    {
+        for (uint32_t a = 0; a < symbolCount; a++)
+        {
+            auto target = this->forward.PerformTransition(q, a);
+            if (target == CompiledDFA<TChar>::DeadState)
+                continue;
+            edges.push_back(target);
+            edges.push_back(a);
+            edges.push_back(q);
+        }
+        if (this->forward.IsAcceptingState(q))
+        {
+            epsilonEdges.push_back(matchStart);
+            epsilonEdges.push_back(q);
+        }
+    }
+    for (uint32_t a = 0; a < symbolCount; a++)
+    {
+        edges.push_back(loopStart);
+        edges.push_back(a);
+        edges.push_back(loopStart);
+    }
+    epsilonEdges.push_back(loopStart);
+    epsilonEdges.push_back(matchStart);
+    std::vector<uint32_t> reverseAccepting(1, this->forward.getStartState());
+    CompiledNFA<TChar> reverseNfa(symbols, stateCount + 2, loopStart, reverseAccepting, edges, epsilonEdges);
+
+    // The looping state is in every subset, so a symbol outside the
+    // alphabet, which kills every other state, leads back to the
+    // start subset.
+    auto reverseDfa = reverseNfa.Determinize();
+    auto table = reverseDfa.getTransitions();
+    auto rowLength = reverseDfa.getRowLength();
+    for (uint32_t q = 1; q < reverseDfa.getStateCount(); q++)
+        table[(std::size_t)q * rowLength + symbolCount] = reverseDfa.getStartState();
+    this->reverse = CompiledDFA<TChar>(symbols, reverseDfa.getStateCount(), reverseDfa.getStartState(),
+                                       table, reverseDfa.getAcceptingStates()).Minimize();
+}
+
+/// \brief Finds the leftmost-longest match in the given byte
+/// string that starts at or after the given offset. Returns
+/// false if there is no such match. The match may be empty.
+template<typename TChar>
+bool Searcher<TChar>::Find(const char* Data, std::size_t Length, std::size_t From, SearchMatch& Result) const
+{
+    From = this->prefilter.FindCandidate(Data, Length, From);
+    if (From == Prefilter::NoPosition)
+        return false;
+
+    auto start = Prefilter::NoPosition;
+    this->FindStarts(Data, Length, From, [&](std::size_t Start) { start = Start; });
+    if (start == Prefilter::NoPosition)
+        return false;
+
+    Result.Start = start;
+    return this->MatchAt(Data, Length, start, Result.End);
+}
+
+/// \brief Finds all non-empty, non-overlapping leftmost-longest
+/// matches in the given byte string, in order.
+template<typename TChar>
+std::vector<SearchMatch> Searcher<TChar>::FindAll(const char* Data, std::size_t Length) const
+{
+    std::vector<SearchMatch> results;
+    auto from = this->prefilter.FindCandidate(Data, Length, 0);
+    if (from == Prefilter::NoPosition)
+        return results;
+
+    // Every match starts at one of the marked offsets, so the forward
+    // automaton only runs from those.
+    std::vector<bool> starts(Length + 1, false);
+    this->FindStarts(Data, Length, from, [&](std::size_t Start) { starts[Start] = true; });
+    SearchMatch match;
+    for (auto position = from; position <= Length; position++)
+    {
+        if (!starts[position])
+            continue;
+        match.Start = position;
+        this->MatchAt(Data, Length, position, match.End);
+        if (match.End > match.Start)
+        {
+            results.push_back(match);
+            position = match.End - 1;
+        }
+    }
+    return results;
+}
+
+/// \brief Runs the reverse automaton backwards over the given
+/// byte string, down to the given offset, and calls the given
+/// function with every offset at or after it at which a match
+/// starts, from right to left.
+template<typename TChar>
+template<typename TStartFunction>
+void Searcher<TChar>::FindStarts(const char* Data, std::size_t Length, std::size_t From, TStartFunction OnStart) const
+{
+    auto columns = this->reverse.getByteColumns();
+    auto rowLength = this->reverse.getRowLength();
+    auto table = this->reverse.getTransitions().data();
+    auto state = this->reverse.getStartState();
+    if (this->reverse.IsAcceptingState(state))
+        OnStart(Length);
+    for (auto i = Length; i > From; i--)
+    {
+        state = table[(std::size_t)state * rowLength + columns[(unsigned char)Data[i - 1]]];
+        if (this->reverse.IsAcceptingState(state))
+            OnStart(i - 1);
+    }
+}
+
+/// \brief Finds the offset at which the longest match that
+/// starts at the given offset ends, or returns false if no
+/// match starts there.
+template<typename TChar>
+bool Searcher<TChar>::MatchAt(const char* Data, std::size_t Length, std::size_t Start, std::size_t& End) const
+{
+    auto columns = this->forward.getByteColumns();
+    auto rowLength = this->forward.getRowLength();
+    auto table = this->forward.getTransitions().data();
+    auto state = this->forward.getStartState();
+    bool found = this->forward.IsAcceptingState(state);
+    if (found)
+        End = Start;
+    for (auto i = Start; i < Length; i++)
+    {
+        state = table[(std::size_t)state * rowLength + columns[(unsigned char)Data[i]]];
+        if (state == CompiledDFA<TChar>::DeadState)
+            break;
+        if (this->forward.IsAcceptingState(state))
+        {
+            End = i + 1;
+            found = true;
+        }
+    }
+    return found;
+}
+
+/// \brief Gets the minimal DFA that recognizes matches that
+/// start at a given position.
+template<typename TChar>
+const CompiledDFA<TChar>& Searcher<TChar>::getForwardAutomaton() const
+{
+    return this->forward;
+}
+
+/// \brief Gets the prefilter that rules out input without
+/// matches.
+template<typename TChar>
+const Prefilter& Searcher<TChar>::getPrefilter() const
+{
+    return this->prefilter;
+}
+
+/// \brief Gets the minimal DFA that accepts the reversal of every
+/// string that starts with a match.
+template<typename TChar>
+const CompiledDFA<TChar>& Searcher<TChar>::getReverseAutomaton() const
+{
+    return this->reverse;
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "SparseSet.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace Automata;
+
+/// \brief Creates an empty sparse set with capacity zero.
+SparseSet::SparseSet()
+{ }
+
+/// \brief Creates an empty sparse set that can hold the integers
+/// in the range [0, Capacity).
+SparseSet::SparseSet(uint32_t Capacity)
+    : sparse(Capacity, 0)
+{
+    this->dense.reserve(Capacity);
+}
+
+/// \brief Adds the given value to this set. Returns true if the
+/// value was not in the set yet.
+bool SparseSet::Add(uint32_t Value)
+{
+    if (this->Contains(Value))
+        return false;
+
+    this->sparse[Value] = (uint32_t)this->dense.size();
+    this->dense.push_back(Value);
+    return true;
+}
+
+/// \brief Removes all values from this set.
+void SparseSet::Clear()
+{
+    this->dense.clear();
+}
+
+/// \brief Checks if this set contains the given value.
+bool SparseSet::Contains(uint32_t Value) const
+{
+    auto index = this->sparse[Value];
+    return index < this->dense.size() && this->dense[index] == Value;
+}
+
+/// \brief Changes the range of integers this set can hold, and
+/// clears it.
+void SparseSet::Resize(uint32_t Capacity)
+{
+    this->dense.clear();
+    this->dense.reserve(Capacity);
+    this->sparse.assign(Capacity, 0);
+}
+
+/// \brief Gets the number of values in this set.
+uint32_t SparseSet::getCount() const
+{
+    return (uint32_t)this->dense.size();
+}
+
+/// \brief Checks if this set is empty.
+bool SparseSet::getIsEmpty() const
+{
+    return this->dense.empty();
+}
+
+/// \brief Gets this set's values, in insertion order.
+const std::vector<uint32_t>& SparseSet::getItems() const
+{
+    return this->dense;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace Automata
+{
+    /// \brief Defines a set of integers in the range [0, capacity) that
+    /// supports constant-time insertion, membership tests and
+    /// clearing. Items are kept in insertion order.
+    class SparseSet
+    {
+    public:
+        /// \brief Creates an empty sparse set with capacity zero.
+        SparseSet();
+
+        /// \brief Creates an empty sparse set that can hold the integers
+        /// in the range [0, Capacity).
+        SparseSet(uint32_t Capacity);
+
+        /// \brief Adds the given value to this set. Returns true if the
+        /// value was not in the set yet.
+        bool Add(uint32_t Value);
+
+        /// \brief Removes all values from this set.
+        void Clear();
+
+        /// \brief Checks if this set contains the given value.
+        bool Contains(uint32_t Value) const;
+
+        /// \brief Changes the range of integers this set can hold, and
+        /// clears it.
+        void Resize(uint32_t Capacity);
+
+        /// \brief Gets the number of values in this set.
+        uint32_t getCount() const;
+
+        /// \brief Checks if this set is empty.
+        bool getIsEmpty() const;
+
+        /// \brief Gets this set's values, in insertion order.
+        const std::vector<uint32_t>& getItems() const;
+    private:
+        std::vector<uint32_t> dense;
+        std::vector<uint32_t> sparse;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "ArraySlice.h"
+#include "CompiledDFA.h"
+#include "CompiledNFA.h"
+
+namespace Automata
+{
+    /// \brief Defines a matcher that consumes its input incrementally,
+    /// one chunk at a time, and can be asked at any point whether the
+    /// input so far is accepted, or whether no continuation of it can
+    /// ever be accepted. A matcher's whole state is a single DFA state
+    /// id, so it uses constant memory, and snapshots are plain integers
+    /// that can be saved and restored in constant time. Matchers share
+    /// their automaton, so copying a matcher starts an independent
+    /// stream without copying the automaton.
+    template<typename TChar>
+    class StreamMatcher
+    {
+    public:
+        /// \brief Describes the state of a stream, which can be used to
+        /// resume matching from the point where it was saved.
+        typedef uint32_t Snapshot;
+
+        /// \brief Creates a matcher for the given automaton, which is
+        /// shared rather than copied. Dead streams are detected exactly
+        /// if the automaton is minimal; otherwise, they are detected
+        /// when they reach the dead state.
+        StreamMatcher(std::shared_ptr<const CompiledDFA<TChar>> Automaton);
+
+        /// \brief Creates a matcher for the minimal automaton that is
+        /// equivalent to the given DFA.
+        StreamMatcher(const CompiledDFA<TChar>& Automaton);
+
+        /// \brief Creates a matcher for the minimal DFA that is
+        /// equivalent to the given NFA or e-NFA.
+        StreamMatcher(const CompiledNFA<TChar>& Automaton);
+
+        /// \brief Feeds the given chunk of symbols to this matcher.
+        void Feed(stdx::ArraySlice<TChar> Characters);
+
+        /// \brief Feeds the given chunk of symbol ids to this matcher.
+        void Feed(const uint32_t* Symbols, std::size_t Length);
+
+        /// \brief Feeds the given chunk of bytes to this matcher.
+        void Feed(const char* Data, std::size_t Length);
+
+        /// \brief Restarts this matcher at the start of a new stream.
+        void Reset();
+
+        /// \brief Resumes this matcher from the given snapshot, which
+        /// must have been saved by a matcher for the same automaton.
+        void Restore(Snapshot Value);
+
+        /// \brief Saves this matcher's state.
+        Snapshot Save() const;
+
+        /// \brief Gets the automaton this matcher runs.
+        const std::shared_ptr<const CompiledDFA<TChar>>& getAutomaton() const;
+
+        /// \brief Checks if the input that has been fed to this matcher
+        /// since the last reset is accepted.
+        bool getIsAccepting() const;
+
+        /// \brief Checks if this matcher is in the dead state, so no
+        /// continuation of the input can be accepted, and feeding it
+        /// more input is pointless.
+        bool getIsDead() const;
+
+        /// \brief Gets the DFA state this matcher is in.
+        uint32_t getState() const;
+    private:
+        std::shared_ptr<const CompiledDFA<TChar>> automaton;
+        uint32_t state;
+    };
+}
+
+#include "StreamMatcher.hxx"
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "StreamMatcher.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "ArraySlice.h"
+#include "CompiledDFA.h"
+#include "CompiledNFA.h"
+
+using namespace Automata;
+
+/// \brief Creates a matcher for the given automaton, which is
+/// shared rather than copied. Dead streams are detected exactly
+/// if the automaton is minimal; otherwise, they are detected
+/// when they reach the dead state.
+template<typename TChar>
+StreamMatcher<TChar>::StreamMatcher(std::shared_ptr<const CompiledDFA<TChar>> Automaton)
+    : automaton(Automaton), state(Automaton->getStartState())
+{ }
+
+/// \brief Creates a matcher for the minimal automaton that is
+/// equivalent to the given DFA.
+template<typename TChar>
+StreamMatcher<TChar>::StreamMatcher(const CompiledDFA<TChar>& Automaton)
+    : StreamMatcher(std::make_shared<const CompiledDFA<TChar>>(Automaton.Minimize()))
+{ }
+
+/// \brief Creates a matcher for the minimal DFA that is
+/// equivalent to the given NFA or e-NFA.
+template<typename TChar>
+StreamMatcher<TChar>::StreamMatcher(const CompiledNFA<TChar>& Automaton)
+    : StreamMatcher(std::make_shared<const CompiledDFA<TChar>>(Automaton.Determinize().Minimize()))
+{ }
+
+/// \brief Feeds the given chunk of symbols to this matcher.
+template<typename TChar>
+void StreamMatcher<TChar>::Feed(stdx::ArraySlice<TChar> Characters)
+{
+    if (this->getIsDead())
+        return;
+
+    auto ids = this->automaton->TranslateSymbols(Characters);
+    this->Feed(ids.data(), ids.size());
+}
+
+/// \brief Feeds the given chunk of symbol ids to this matcher.
+template<typename TChar>
+void StreamMatcher<TChar>::Feed(const uint32_t* Symbols, std::size_t Length)
+{
+    if (!this->getIsDead())
+        this->state = this->automaton->PerformExtendedTransition(this->state, Symbols, Length);
+}
+
+/// \brief Feeds the given chunk of bytes to this matcher.
+template<typename TChar>
+void StreamMatcher<TChar>::Feed(const char* Data, std::size_t Length)
+{
+    if (!this->getIsDead())
+        this->state = this->automaton->PerformExtendedTransition(this->state, Data, Length);
+}
+
+/// \brief Restarts this matcher at the start of a new stream.
+template<typename TChar>
+void StreamMatcher<TChar>::Reset()
+{
+    this->state = this->automaton->getStartState();
+}
+
+/// \brief Resumes this matcher from the given snapshot, which
+/// must have been saved by a matcher for the same automaton.
+template<typename TChar>
+void StreamMatcher<TChar>::Restore(Snapshot Value)
+{
+    this->state = Value;
+}
+
+/// \brief Saves this matcher's state.
+template<typename TChar>
+typename StreamMatcher<TChar>::Snapshot StreamMatcher<TChar>::Save() const
+{
+    return this->state;
+}
+
+/// \brief Gets the automaton this matcher runs.
+template<typename TChar>
+const std::shared_ptr<const CompiledDFA<TChar>>& StreamMatcher<TChar>::getAutomaton() const
+{
+    return this->automaton;
+}
+
+/// \brief Checks if the input that has been fed to this matcher
+/// since the last reset is accepted.
+template<typename TChar>
+bool StreamMatcher<TChar>::getIsAccepting() const
+{
+    return this->automaton->IsAcceptingState(this->state);
+}
+
+/// \brief Checks if this matcher is in the dead state, so no
+/// continuation of the input can be accepted, and feeding it
+/// more input is pointless.
+template<typename TChar>
+bool StreamMatcher<TChar>::getIsDead() const
+{
+    return this->state == CompiledDFA<TChar>::DeadState;
+}
+
+/// \brief Gets the DFA state this matcher is in.
+template<typename TChar>
+uint32_t StreamMatcher<TChar>::getState() const
+{
+    return this->state;
+}
\ No newline at end of file
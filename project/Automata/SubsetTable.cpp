@@ -0,0 +1,142 @@
+#include "SubsetTable.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace Automata;
+
+const uint32_t SubsetTable::NoSubset;
+
+/// \brief Creates an empty subset table.
+SubsetTable::SubsetTable()
+    : offsets(1, 0), slots(16, NoSubset)
+{ }
+
+/// \brief Finds the id of the given sorted set of state ids, and
+/// adds the set to this table if it is not in it yet. Added is
+/// set to true if the set was added.
+uint32_t SubsetTable::Add(const uint32_t* Items, std::size_t Count, bool& Added)
+{
+    auto hashCode = Hash(Items, Count);
+    auto slot = this->FindSlot(Items, Count, hashCode);
+    if (this->slots[slot] != NoSubset)
+    {
+        Added = false;
+        return this->slots[slot];
+    }
+
+    auto id = this->getCount();
+    this->items.insert(this->items.end(), Items, Items + Count);
+    this->offsets.push_back(this->items.size());
+    this->hashes.push_back(hashCode);
+    this->slots[slot] = id;
+    // Keep the load factor at or below one half.
+    if ((std::size_t)this->getCount() * 2 > this->slots.size())
+        this->Grow();
+    Added = true;
+    return id;
+}
+
+/// \brief Removes all sets from this table.
+void SubsetTable::Clear()
+{
+    this->items.clear();
+    this->offsets.assign(1, 0);
+    this->hashes.clear();
+    std::fill(this->slots.begin(), this->slots.end(), NoSubset);
+}
+
+/// \brief Finds the id of the given sorted set of state ids, or
+/// returns NoSubset if it is not in this table.
+uint32_t SubsetTable::Find(const uint32_t* Items, std::size_t Count) const
+{
+    return this->slots[this->FindSlot(Items, Count, Hash(Items, Count))];
+}
+
+/// \brief Gets the items of the set with the given id.
+const uint32_t* SubsetTable::GetItems(uint32_t Id) const
+{
+    return this->items.data() + this->offsets[Id];
+}
+
+/// \brief Gets the number of items in the set with the given id.
+uint32_t SubsetTable::GetSize(uint32_t Id) const
+{
+    return (uint32_t)(this->offsets[Id + 1] - this->offsets[Id]);
+}
+
+/// \brief Gets a copy of the set with the given id.
+std::vector<uint32_t> SubsetTable::GetSubset(uint32_t Id) const
+{
+    return std::vector<uint32_t>(this->items.begin() + this->offsets[Id],
+                                 this->items.begin() + this->offsets[Id + 1]);
+}
+
+/// \brief Gets the number of sets in this table.
+uint32_t SubsetTable::getCount() const
+{
+    return (uint32_t)this->hashes.size();
+}
+
+/// \brief Gets the total number of state ids stored in this
+/// table's sets.
+std::size_t SubsetTable::getItemCount() const
+{
+    return this->items.size();
+}
+
+/// \brief Computes the hash code of the given set of state ids.
+uint64_t SubsetTable::Hash(const uint32_t* Items, std::size_t Count)
+{
+    // FNV-1a over whole ids, followed by a final avalanche step so the
+    // low bits can be used as a slot index directly.
+    uint64_t result = 14695981039346656037ULL;
+    for (std::size_t i = 0; i < Count; i++)
+    {
+        result ^= Items[i];
+        result *= 1099511628211ULL;
+    }
+    result ^= result >> 33;
+    result *= 0xff51afd7ed558ccdULL;
+    result ^= result >> 33;
+    return result;
+}
+
+/// \brief Finds the slot that holds the given set, or the empty
+/// slot where it should be inserted.
+std::size_t SubsetTable::FindSlot(const uint32_t* Items, std::size_t Count, uint64_t HashCode) const
+{
+    auto mask = this->slots.size() - 1;
+    auto slot = (std::size_t)HashCode & mask;
+    while (this->slots[slot] != NoSubset)
+    {
+        auto id = this->slots[slot];
+        if (this->hashes[id] == HashCode && this->GetSize(id) == Count)
+        {
+            auto other = this->GetItems(id);
+            std::size_t i = 0;
+            while (i < Count && Items[i] == other[i])
+                i++;
+            if (i == Count)
+                return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/// \brief Doubles the number of slots, and re-inserts all sets.
+void SubsetTable::Grow()
+{
+    this->slots.assign(this->slots.size() * 2, NoSubset);
+    auto mask = this->slots.size() - 1;
+    for (uint32_t id = 0; id < this->getCount(); id++)
+    {
+        auto slot = (std::size_t)this->hashes[id] & mask;
+        while (this->slots[slot] != NoSubset)
+            slot = (slot + 1) & mask;
+        this->slots[slot] = id;
+    }
+}
\ No newline at end of file
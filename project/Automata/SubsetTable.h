@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Automata
+{
+    /// \brief Defines a hash-consing table for sets of state ids. Every
+    /// distinct set is stored once, in canonical (sorted) form, and is
+    /// assigned a dense id in order of insertion. All sets share a
+    /// single item buffer, and lookups go through an open-addressing
+    /// hash table of ids, so a set costs a few words of overhead.
+    class SubsetTable
+    {
+    public:
+        /// \brief The id that denotes the absence of a set.
+        static const uint32_t NoSubset = 0xFFFFFFFF;
+
+        /// \brief Creates an empty subset table.
+        SubsetTable();
+
+        /// \brief Finds the id of the given sorted set of state ids, and
+        /// adds the set to this table if it is not in it yet. Added is
+        /// set to true if the set was added.
+        uint32_t Add(const uint32_t* Items, std::size_t Count, bool& Added);
+
+        /// \brief Removes all sets from this table.
+        void Clear();
+
+        /// \brief Finds the id of the given sorted set of state ids, or
+        /// returns NoSubset if it is not in this table.
+        uint32_t Find(const uint32_t* Items, std::size_t Count) const;
+
+        /// \brief Gets the items of the set with the given id.
+        const uint32_t* GetItems(uint32_t Id) const;
+
+        /// \brief Gets the number of items in the set with the given id.
+        uint32_t GetSize(uint32_t Id) const;
+
+        /// \brief Gets a copy of the set with the given id.
+        std::vector<uint32_t> GetSubset(uint32_t Id) const;
+
+        /// \brief Gets the number of sets in this table.
+        uint32_t getCount() const;
+
+        /// \brief Gets the total number of state ids stored in this
+        /// table's sets.
+        std::size_t getItemCount() const;
+    private:
+        /// \brief Computes the hash code of the given set of state ids.
+        static uint64_t Hash(const uint32_t* Items, std::size_t Count);
+
+        /// \brief Finds the slot that holds the given set, or the empty
+        /// slot where it should be inserted.
+        std::size_t FindSlot(const uint32_t* Items, std::size_t Count, uint64_t HashCode) const;
+
+        /// \brief Doubles the number of slots, and re-inserts all sets.
+        void Grow();
+
+        std::vector<uint32_t> items;
+        std::vector<std::size_t> offsets;
+        std::vector<uint64_t> hashes;
+        std::vector<uint32_t> slots;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ArraySlice.h"
+
+namespace Automata
+{
+    /// \brief Gets the byte that the given symbol consists of, if it
+    /// consists of a single byte.
+    inline bool TryGetSymbolByte(const std::string& Symbol, unsigned char& Result)
+    {
+        if (Symbol.size() != 1)
+            return false;
+
+        Result = (unsigned char)Symbol[0];
+        return true;
+    }
+
+    /// \brief Gets the byte that the given symbol consists of.
+    inline bool TryGetSymbolByte(char Symbol, unsigned char& Result)
+    {
+        Result = (unsigned char)Symbol;
+        return true;
+    }
+
+    /// \brief Symbols of any other type never consist of a single byte.
+    template<typename TChar>
+    inline bool TryGetSymbolByte(const TChar& Symbol, unsigned char& Result)
+    {
+        return false;
+    }
+
+    /// \brief Defines a table that interns symbols as small, dense
+    /// integer ids, in order of first appearance. Single-byte symbols
+    /// are also kept in a 256-entry table, so raw character input can
+    /// be translated without hashing or allocating a symbol per
+    /// character.
+    template<typename TChar>
+    class SymbolTable
+    {
+    public:
+        /// \brief The id that unknown symbols and bytes are mapped to.
+        static const uint32_t NoSymbol = 0xFFFFFFFF;
+
+        /// \brief Creates an empty symbol table.
+        SymbolTable();
+
+        /// \brief Creates a symbol table that contains the given symbols,
+        /// which are assigned ids in order. Duplicate symbols are
+        /// interned only once.
+        SymbolTable(std::vector<TChar> Symbols);
+
+        /// \brief Checks if this table contains the given symbol.
+        bool Contains(const TChar& Symbol) const;
+
+        /// \brief Gets the id of the symbol that consists of the given
+        /// byte, or NoSymbol if there is no such symbol.
+        uint32_t GetByteId(unsigned char Byte) const;
+
+        /// \brief Gets the id of the given symbol, or NoSymbol if it is not
+        /// in this table.
+        uint32_t GetId(const TChar& Symbol) const;
+
+        /// \brief Gets the symbol with the given id.
+        const TChar& GetSymbol(uint32_t Id) const;
+
+        /// \brief Interns the given symbol, and returns its id.
+        uint32_t Intern(const TChar& Symbol);
+
+        /// \brief Converts the given string of symbols to a string of
+        /// symbol ids. Unknown symbols are mapped to the given id.
+        std::vector<uint32_t> Translate(stdx::ArraySlice<TChar> Symbols, uint32_t UnknownId) const;
+
+        /// \brief Converts the given bytes to symbol ids, and stores them
+        /// in the given array. Bytes that do not correspond to a
+        /// symbol are mapped to the given id.
+        void TranslateBytes(const char* Data, std::size_t Length, uint32_t UnknownId, uint32_t* Result) const;
+
+        /// \brief Gets the 256-entry table that maps bytes to the ids of
+        /// the symbols that consist of them.
+        const uint32_t* getByteIds() const;
+
+        /// \brief Gets the number of symbols in this table.
+        uint32_t getCount() const;
+
+        /// \brief Checks if every symbol in this table consists of a
+        /// single byte.
+        bool getIsByteAlphabet() const;
+
+        /// \brief Gets this table's symbols. A symbol's id is its index in
+        /// this vector.
+        const std::vector<TChar>& getSymbols() const;
+    private:
+        std::vector<TChar> symbols;
+        std::unordered_map<TChar, uint32_t> ids;
+        std::vector<uint32_t> byteIds;
+        bool isByteAlphabet;
+    };
+}
+
+#include "SymbolTable.hxx"
\ No newline at end of file
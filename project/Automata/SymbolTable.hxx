@@ -0,0 +1,146 @@
+#include "SymbolTable.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "ArraySlice.h"
+
+using namespace Automata;
+
+template<typename TChar>
+const uint32_t SymbolTable<TChar>::NoSymbol;
+
+/// \brief Creates an empty symbol table.
+template<typename TChar>
+SymbolTable<TChar>::SymbolTable()
+    : byteIds(256, NoSymbol), isByteAlphabet(true)
+{ }
+
+/// \brief Creates a symbol table that contains the given symbols,
+/// which are assigned ids in order. Duplicate symbols are
+/// interned only once.
+template<typename TChar>
+SymbolTable<TChar>::SymbolTable(std::vector<TChar> Symbols)
+    : byteIds(256, NoSymbol), isByteAlphabet(true)
+{
+    for (auto& item : Symbols)
+        this->Intern(item);
+}
+
+/// \brief Checks if this table contains the given symbol.
+template<typename TChar>
+bool SymbolTable<TChar>::Contains(const TChar& Symbol) const
+{
+    return this->ids.find(Symbol) != this->ids.end();
+}
+
+/// \brief Gets the id of the symbol that consists of the given
+/// byte, or NoSymbol if there is no such symbol.
+template<typename TChar>
+uint32_t SymbolTable<TChar>::GetByteId(unsigned char Byte) const
+{
+    return this->byteIds[Byte];
+}
+
+/// \brief Gets the id of the given symbol, or NoSymbol if it is not
+/// in this table.
+template<typename TChar>
+uint32_t SymbolTable<TChar>::GetId(const TChar& Symbol) const
+{
+    unsigned char byte;
+    if (this->isByteAlphabet && TryGetSymbolByte(Symbol, byte))
+        return this->byteIds[byte];
+
+    auto iter = this->ids.find(Symbol);
+    if (iter == this->ids.end())
+        return NoSymbol;
+    else
+        return iter->second;
+}
+
+/// \brief Gets the symbol with the given id.
+template<typename TChar>
+const TChar& SymbolTable<TChar>::GetSymbol(uint32_t Id) const
+{
+    return this->symbols[Id];
+}
+
+/// \brief Interns the given symbol, and returns its id.
+template<typename TChar>
+uint32_t SymbolTable<TChar>::Intern(const TChar& Symbol)
+{
+    auto iter = this->ids.find(Symbol);
+    if (iter != this->ids.end())
+        return iter->second;
+
+    auto id = (uint32_t)this->symbols.size();
+    this->ids[Symbol] = id;
+    this->symbols.push_back(Symbol);
+    unsigned char byte;
+    if (TryGetSymbolByte(Symbol, byte))
+        this->byteIds[byte] = id;
+    else
+        this->isByteAlphabet = false;
+    return id;
+}
+
+/// \brief Converts the given string of symbols to a string of
+/// symbol ids. Unknown symbols are mapped to the given id.
+template<typename TChar>
+std::vector<uint32_t> SymbolTable<TChar>::Translate(stdx::ArraySlice<TChar> Symbols, uint32_t UnknownId) const
+{
+    std::vector<uint32_t> results;
+    results.reserve(Symbols.GetLength());
+    for (auto& item : Symbols)
+    {
+        auto id = this->GetId(item);
+        results.push_back(id == NoSymbol ? UnknownId : id);
+    }
+    return results;
+}
+
+/// \brief Converts the given bytes to symbol ids, and stores them
+/// in the given array. Bytes that do not correspond to a
+/// symbol are mapped to the given id.
+template<typename TChar>
+void SymbolTable<TChar>::TranslateBytes(const char* Data, std::size_t Length, uint32_t UnknownId, uint32_t* Result) const
+{
+    auto byteIds = this->byteIds.data();
+    for (std::size_t i = 0; i < Length; i++)
+    {
+        auto id = byteIds[(unsigned char)Data[i]];
+        Result[i] = id == NoSymbol ? UnknownId : id;
+    }
+}
+
+/// \brief Gets the 256-entry table that maps bytes to the ids of
+/// the symbols that consist of them.
+template<typename TChar>
+const uint32_t* SymbolTable<TChar>::getByteIds() const
+{
+    return this->byteIds.data();
+}
+
+/// \brief Gets the number of symbols in this table.
+template<typename TChar>
+uint32_t SymbolTable<TChar>::getCount() const
+{
+    return (uint32_t)this->symbols.size();
+}
+
+/// \brief Checks if every symbol in this table consists of a
+/// single byte.
+template<typename TChar>
+bool SymbolTable<TChar>::getIsByteAlphabet() const
+{
+    return this->isByteAlphabet;
+}
+
+/// \brief Gets this table's symbols. A symbol's id is its index in
+/// this vector.
+template<typename TChar>
+const std::vector<TChar>& SymbolTable<TChar>::getSymbols() const
+{
+    return this->symbols;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "ThompsonBuilder.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "ENFAutomaton.h"
+#include "HashExtensions.h"
+#include "LinearSet.h"
+#include "Optional.h"
+#include "TransitionTable.h"
+
+using namespace Automata;
+
+/// \brief Creates a fragment from the given start and accepting
+/// states.
+RegexFragment::RegexFragment(uint32_t Start, uint32_t Accept)
+    : Start(Start), Accept(Accept)
+{ }
+
+/// \brief Creates an empty builder.
+ThompsonBuilder::ThompsonBuilder()
+    : stateCount(0)
+{ }
+
+/// \brief Adds an epsilon transition between the given states.
+void ThompsonBuilder::AddEpsilonTransition(uint32_t From, uint32_t To)
+{
+    this->transitions[std::make_pair(From, Optional<std::string>())].Add(To);
+}
+
+/// \brief Adds a transition between the given states that is
+/// labeled with the given symbol.
+void ThompsonBuilder::AddTransition(uint32_t From, std::string Symbol, uint32_t To)
+{
+    this->transitions[std::make_pair(From, Optional<std::string>(Symbol))].Add(To);
+}
+
+/// \brief Creates a new state, and returns its id.
+uint32_t ThompsonBuilder::CreateState()
+{
+    return this->stateCount++;
+}
+
+/// \brief Creates an e-NFA from the transitions that have been
+/// added to this builder, whose start and accepting states are
+/// those of the given fragment.
+ENFAutomaton<uint32_t, std::string> ThompsonBuilder::ToENFAutomaton(const RegexFragment& Fragment) const
+{
+    LinearSet<uint32_t> acceptingStates;
+    acceptingStates.Add(Fragment.Accept);
+    TransitionTable<std::pair<uint32_t, Optional<std::string>>, LinearSet<uint32_t>> transTable(this->transitions);
+    return ENFAutomaton<uint32_t, std::string>(Fragment.Start,
+                                               acceptingStates,
+                                               transTable);
+}
+
+/// \brief Gets the number of states this builder has created.
+uint32_t ThompsonBuilder::getStateCount() const
+{
+    return this->stateCount;
+}
\ No newline at end of file
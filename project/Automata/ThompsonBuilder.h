@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "ENFAutomaton.h"
+#include "HashExtensions.h"
+#include "LinearSet.h"
+#include "Optional.h"
+
+namespace Automata
+{
+    /// \brief Describes a piece of an e-NFA under construction that
+    /// has a single start state and a single accepting state.
+    struct RegexFragment
+    {
+        /// \brief Creates a fragment from the given start and accepting
+        /// states.
+        RegexFragment(uint32_t Start, uint32_t Accept);
+
+        /// \brief The fragment's start state.
+        uint32_t Start;
+        /// \brief The fragment's accepting state.
+        uint32_t Accept;
+    };
+
+    /// \brief Defines a builder for the Thompson construction. Regexes
+    /// append their states and transitions to a single builder, and
+    /// only pass fragments around, so building an e-NFA takes time and
+    /// memory linear in the size of the regex. States are dense integer
+    /// ids, which are handed out in order of creation.
+    class ThompsonBuilder
+    {
+    public:
+        /// \brief Creates an empty builder.
+        ThompsonBuilder();
+
+        /// \brief Adds an epsilon transition between the given states.
+        void AddEpsilonTransition(uint32_t From, uint32_t To);
+
+        /// \brief Adds a transition between the given states that is
+        /// labeled with the given symbol.
+        void AddTransition(uint32_t From, std::string Symbol, uint32_t To);
+
+        /// \brief Creates a new state, and returns its id.
+        uint32_t CreateState();
+
+        /// \brief Creates an e-NFA from the transitions that have been
+        /// added to this builder, whose start and accepting states are
+        /// those of the given fragment.
+        ENFAutomaton<uint32_t, std::string> ToENFAutomaton(const RegexFragment& Fragment) const;
+
+        /// \brief Gets the number of states this builder has created.
+        uint32_t getStateCount() const;
+    private:
+        std::unordered_map<std::pair<uint32_t, Optional<std::string>>, LinearSet<uint32_t>> transitions;
+        uint32_t stateCount;
+    };
+}
\ No newline at end of file
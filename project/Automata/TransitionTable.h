@@ -20,10 +20,11 @@ namespace Automata
 
         void Add(TSource Source, TTarget Target);
 
-        /// \brief Applies the function to the given value.
+        /// \brief Applies the function to the given value. Values that are
+        /// not in the table are mapped to a default-constructed target.
         TTarget Apply(TSource Value) const override;
 
-        std::unordered_map<TSource, TTarget> getMap() const;
+        const std::unordered_map<TSource, TTarget>& getMap() const;
     private:
         std::unordered_map<TSource, TTarget> table;
     };
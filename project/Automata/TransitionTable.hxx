@@ -35,15 +35,20 @@ void TransitionTable<TSource, TTarget>::Add(TSource Source, TTarget Target)
     this->table[Source] = Target;
 }
 
-/// \brief Applies the function to the given value.
+/// \brief Applies the function to the given value. Values that are
+/// not in the table are mapped to a default-constructed target.
 template<typename TSource, typename TTarget>
 TTarget TransitionTable<TSource, TTarget>::Apply(TSource Value) const
 {
-    return this->getMap()[Value];
+    auto iter = this->table.find(Value);
+    if (iter == this->table.end())
+        return TTarget();
+    else
+        return iter->second;
 }
 
 template<typename TSource, typename TTarget>
-std::unordered_map<TSource, TTarget> TransitionTable<TSource, TTarget>::getMap() const
+const std::unordered_map<TSource, TTarget>& TransitionTable<TSource, TTarget>::getMap() const
 {
     return this->table;
 }
\ No newline at end of file
@@ -1,54 +1,54 @@
 #include "UnionRegex.h"
 
+#include <cstddef>
 #include <memory>
 #include <string>
-#include <utility>
-#include "ENFAutomaton.h"
 #include "IRegex.h"
-#include "LinearSet.h"
-#include "Optional.h"
-#include "RegexState.h"
-#include "TransitionTable.h"
+#include "ThompsonBuilder.h"
 
 using namespace Automata;
 
 UnionRegex::UnionRegex(std::shared_ptr<IRegex> Left, std::shared_ptr<IRegex> Right)
-    : Left(Left), Right(Right)
+    : Left(Left), Right(Right),
+      hashCode(CombineHashes(CombineHashes(UnionKind, Left->getHashCode()), Right->getHashCode()))
 { }
 
-/// \brief Creates an epsilon-nfa for this union regex.
-/// The construction is as follows:   
-/// * Automata are constructed for the left and right operands of this union
-///   operation.   
-/// * These automata are "merged":     
-///   * A new start state is created, with epsilon-transitions going out
-///     to the left and right automata.
-/// * The accepting states of the resulting automaton is
-///   union of the accepting states of the left and right
-///   operands' automata.
-ENFAutomaton<std::shared_ptr<RegexState>, std::string> UnionRegex::ToENFAutomaton() const
+/// \brief Appends this union regex's e-NFA to the given builder.
+/// The construction is as follows:
+/// * Fragments are appended for the left and right operands.
+/// * A new start state is created, with epsilon-transitions going
+///   out to the left and right fragments.
+/// * A new accepting state is created, with epsilon-transitions
+///   coming in from the left and right fragments' accepting
+///   states.
+RegexFragment UnionRegex::AppendENFAutomaton(ThompsonBuilder& Builder) const
 {
-    auto startState = std::make_shared<RegexState>();
-    TransitionTable<std::pair<std::shared_ptr<RegexState>, Optional<std::string>>, LinearSet<std::shared_ptr<RegexState>>> transTable;
-    auto leftAutomaton = this->Left->ToENFAutomaton();
-    auto rightAutomaton = this->Right->ToENFAutomaton();
-    transTable.Add(leftAutomaton.getTransitionFunction());
-    transTable.Add(rightAutomaton.getTransitionFunction());
-    std::pair<std::shared_ptr<RegexState>, Optional<std::string>> label(startState, 
-                                                                        Optional<std::string>());
-    LinearSet<std::shared_ptr<RegexState>> redirectedStates;
-    redirectedStates.Add(leftAutomaton.getStartState());
-    redirectedStates.Add(rightAutomaton.getStartState());
-    transTable.Add(label, redirectedStates);
-    auto acceptingStates = leftAutomaton.getAcceptingStates();
-    acceptingStates.AddAll(rightAutomaton.getAcceptingStates());
-    return ENFAutomaton<std::shared_ptr<RegexState>, std::string>(startState, 
-                                                                  acceptingStates, 
-                                                                  transTable);
+    auto startState = Builder.CreateState();
+    auto left = this->Left->AppendENFAutomaton(Builder);
+    auto right = this->Right->AppendENFAutomaton(Builder);
+    auto endState = Builder.CreateState();
+    Builder.AddEpsilonTransition(startState, left.Start);
+    Builder.AddEpsilonTransition(startState, right.Start);
+    Builder.AddEpsilonTransition(left.Accept, endState);
+    Builder.AddEpsilonTransition(right.Accept, endState);
+    return RegexFragment(startState, endState);
 }
 
 /// \brief Gets this regex's string representation.
 std::string UnionRegex::ToString() const
 {
     return this->Left->ToString() + "+" + this->Right->ToString();
+}
+
+/// \brief Gets this regex's hash code, which depends on its
+/// structure only, and is computed when the regex is created.
+std::size_t UnionRegex::getHashCode() const
+{
+    return this->hashCode;
+}
+
+/// \brief Gets this regex's kind.
+RegexKind UnionRegex::getKind() const
+{
+    return UnionKind;
 }
\ No newline at end of file
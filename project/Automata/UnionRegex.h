@@ -1,9 +1,10 @@
 #pragma once
+#include <cstddef>
 #include <memory>
 #include <string>
 #include "ENFAutomaton.h"
 #include "IRegex.h"
-#include "RegexState.h"
+#include "ThompsonBuilder.h"
 
 namespace Automata
 {
@@ -12,21 +13,29 @@ namespace Automata
     {
         UnionRegex(std::shared_ptr<IRegex> Left, std::shared_ptr<IRegex> Right);
 
-        /// \brief Creates an epsilon-nfa for this union regex.
-        /// The construction is as follows:   * Automata are
-        /// constructed for the left and right operands of this union
-        /// operation.   * These automata are "merged":     * A new
-        /// start state is created, with epsilon-transitions going out
-        /// to the left and right automata.
-        /// * The accepting states of the resulting automaton is
-        /// union of the       accepting states of the left and right
-        /// operands' automata.
-        ENFAutomaton<std::shared_ptr<RegexState>, std::string> ToENFAutomaton() const override;
+        /// \brief Appends this union regex's e-NFA to the given builder.
+        /// The construction is as follows:
+        /// * Fragments are appended for the left and right operands.
+        /// * A new start state is created, with epsilon-transitions going
+        ///   out to the left and right fragments.
+        /// * A new accepting state is created, with epsilon-transitions
+        ///   coming in from the left and right fragments' accepting
+        ///   states.
+        RegexFragment AppendENFAutomaton(ThompsonBuilder& Builder) const override;
 
         /// \brief Gets this regex's string representation.
         std::string ToString() const override;
 
+        /// \brief Gets this regex's hash code, which depends on its
+        /// structure only, and is computed when the regex is created.
+        std::size_t getHashCode() const override;
+
+        /// \brief Gets this regex's kind.
+        RegexKind getKind() const override;
+
         std::shared_ptr<IRegex> Left;
         std::shared_ptr<IRegex> Right;
+    private:
+        std::size_t hashCode;
     };
 }
\ No newline at end of file